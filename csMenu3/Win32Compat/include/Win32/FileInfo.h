@@ -0,0 +1,84 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace fileinfo {
+
+  enum class Type : unsigned {
+    Invalid = 0, // Does not exist or is not accessible
+    File,
+    Directory
+  };
+
+  // cf. FILE_ATTRIBUTE_*
+  enum Attribute : uint32_t {
+    ReadOnly     = 0x00000001,
+    Hidden       = 0x00000002,
+    System       = 0x00000004,
+    Archive      = 0x00000020,
+    ReparsePoint = 0x00000400,
+    Compressed   = 0x00000800,
+    Offline      = 0x00001000,
+    Encrypted    = 0x00004000
+  };
+
+  struct Info {
+    Type type{Type::Invalid};
+    uint32_t attributes{0};
+    uint64_t size{0};
+    uint64_t ctime{0}; // cf. mtime
+    uint64_t mtime{0}; // FILETIME, i.e. 100ns intervals since 1601-01-01 (UTC)
+    uint64_t id{0};    // Unique per volume
+  };
+
+  using ListFunc = std::function<void(const std::wstring_view& name, const Info& info)>;
+
+  // Information on a single file system object; follows symbolic links, but
+  // keeps attribute ReparsePoint to flag the object itself as a link.
+  Info query(const wchar_t *filename);
+
+  // The final, i.e. canonical, path of the file system object; without any
+  // symbolic links, junctions or substituted drives. Empty on error.
+  std::wstring finalPath(const wchar_t *filename);
+
+  // Information on all of the directory's entries, in as few round trips as
+  // possible; reparse points (e.g. symbolic links) are reported as the links
+  // themselves, i.e. with attribute ReparsePoint and without following them.
+  bool list(const wchar_t *dirname, const ListFunc& func);
+
+} // namespace fileinfo
@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Win32/Compat.h"
+
+namespace fileop {
+
+  // Renames a file system object; never replaces an existing object.
+  bool rename(const wchar_t *from, const wchar_t *to);
+
+  // Creates a new, uniquely named file next to 'filename' & writes data to it;
+  // returns the file's name. Existing files are never replaced; on failure,
+  // the file is removed & an empty name is returned.
+  std::wstring writeTemporary(const wchar_t *filename, const std::string_view& data);
+
+  /*
+   * NOTE: A Directory is opened once; its entries are then renamed by their
+   *       leaf names, relative to the directory's handle. Hence the path of
+   *       the directory is resolved once per batch, not twice per rename.
+   *       Renames are thread-safe; threads may share one instance.
+   */
+
+  class Directory {
+  public:
+    Directory(const wchar_t *dirname) noexcept;
+    ~Directory() noexcept;
+
+    Directory(const Directory&) = delete;
+    Directory& operator=(const Directory&) = delete;
+
+    bool isOpen() const;
+
+    // Renames the entry 'from' to 'to', both being leaf names; never replaces
+    // an existing entry. Falls back to full paths, if the directory is not open.
+    bool rename(const std::wstring_view& from, const std::wstring_view& to) const;
+
+  private:
+    std::wstring path(const std::wstring_view& name) const;
+
+    std::wstring _dirname{};
+    HANDLE_t _handle{nullptr};
+  };
+
+} // namespace fileop
@@ -31,6 +31,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 namespace shell {
 
   void execute(const wchar_t *executable,
@@ -39,4 +42,41 @@ namespace shell {
 
   void notifyAssocChanged();
 
+  /*
+   * NOTE: A Launcher resolves how to run a program only once, i.e. its file
+   *       association's command and the interpreter's full path, and then
+   *       starts the program per execute() via CreateProcess(); this avoids
+   *       ShellExecuteEx()'s association lookup per call. The environment is
+   *       captured once, too, and no handles are inherited.
+   *
+   *       Programs that can not be resolved (e.g. DDE, "%2" in a command)
+   *       are started by execute() above instead. execute() is thread-safe.
+   */
+
+  class Launcher {
+  public:
+    Launcher(const wchar_t *program) noexcept;
+    ~Launcher() noexcept;
+
+    Launcher(const Launcher&) = delete;
+    Launcher& operator=(const Launcher&) = delete;
+
+    bool isResolved() const;
+
+    // Longest arguments execute() accepts; cf. CreateProcess().
+    std::size_t maxArguments() const;
+
+    // Runs the program with arguments & waits for it to exit.
+    bool execute(const wchar_t *arguments) const;
+
+  private:
+    bool resolve();
+
+    std::wstring _program{};
+    std::wstring _application{}; // Full path
+    std::wstring _prefix{};      // Command line: _prefix + arguments + _suffix
+    std::wstring _suffix{};
+    std::vector<wchar_t> _environment{};
+  };
+
 } // namespace shell
@@ -33,6 +33,20 @@
 
 #include <cstddef>
 
+#include <string>
+
 constexpr std::size_t MAX_STRLEN = 0x7fffffff; // STRSAFE_MAX_CCH
 
 std::size_t StringLength(const wchar_t *str, const std::size_t max = MAX_STRLEN);
+
+// Upper case of the first length characters of src, independent of any locale;
+// dest has to provide room for length characters.
+bool StringToUpper(wchar_t *dest, const wchar_t *src, const std::size_t length);
+
+// Lower case of the first length characters of src; cf. StringToUpper().
+bool StringToLower(wchar_t *dest, const wchar_t *src, const std::size_t length);
+
+// Appends the sort key of the first length characters of str to key, i.e. the
+// user's locale's collation ignoring case & with digits as numbers; keys then
+// compare ordinally & never contain characters below U+0100.
+bool StringSortKey(std::wstring& key, const wchar_t *str, const std::size_t length);
@@ -35,6 +35,10 @@
 
 namespace ui {
 
+  // Messages in [DIALOG_USER, DIALOG_USER_LAST] are passed to onUser(); cf. WM_APP.
+  inline constexpr UINT_t DIALOG_USER      = 0x8000;
+  inline constexpr UINT_t DIALOG_USER_LAST = 0xBFFF;
+
   class Dialog : public Window {
   public:
     Dialog() noexcept;
@@ -44,6 +48,9 @@ namespace ui {
     virtual LRESULT_t onInitDialog(HWND_t wnd, LPARAM_t lParam); // WM_INITDIALOG
     virtual LRESULT_t onOk(WPARAM_t wParam, LPARAM_t lParam);
     virtual LRESULT_t onCancel(WPARAM_t wParam, LPARAM_t lParam);
+    virtual LRESULT_t onNotify(WPARAM_t wParam, LPARAM_t lParam); // WM_NOTIFY
+    virtual LRESULT_t onTimer(WPARAM_t wParam, LPARAM_t lParam);  // WM_TIMER
+    virtual LRESULT_t onUser(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam);
 
     bool exec(HINSTANCE_t instance, HWND_t parent = nullptr);
 
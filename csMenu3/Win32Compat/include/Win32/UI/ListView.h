@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "Win32/UI/Window.h"
+
+namespace ui {
+
+  /*
+   * NOTE: The list view must be created with the LVS_REPORT & LVS_OWNERDATA
+   *       styles, i.e. it is virtual: Its owner provides the items' texts on
+   *       demand (LVN_GETDISPINFO) and only visible items are ever queried.
+   *
+   *       initialize() must be called before creating the list view.
+   */
+
+  class ListView : public Window {
+  private:
+    struct ctor_tag {
+      ctor_tag() noexcept = default;
+    };
+
+  public:
+    ListView(HWND_t wnd, const ctor_tag& = ctor_tag()) noexcept;
+    ListView(HWND_t dlg, int idDlgItem, const ctor_tag& = ctor_tag()) noexcept;
+    ~ListView() noexcept;
+
+    bool insertColumn(const int index, const std::wstring& title, const int width);
+    bool redrawItems(const int first, const int last);
+    void redrawAll();
+    void setFullRowSelect(const bool on);
+    bool setItemCount(const int count);
+    int width() const;
+
+    static bool initialize();
+
+    static WindowPtr create(HWND_t wnd);
+    static WindowPtr create(HWND_t dlg, int idDlgItem);
+  };
+
+  inline ListView *LISTVIEW(const Window *w)
+  {
+    return dynamic_cast<ListView *>(const_cast<Window *>(w));
+  }
+
+  inline ListView *LISTVIEW(const WindowPtr& p)
+  {
+    return dynamic_cast<ListView *>(p.get());
+  }
+
+} // namespace ui
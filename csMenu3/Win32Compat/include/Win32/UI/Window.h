@@ -51,6 +51,7 @@ namespace ui {
 
     int controlId() const;
 
+    bool postMessage(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam) const; // Thread-safe
     LRESULT_t sendMessage(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam) const;
 
     LONG_PTR_t userData() const;
@@ -58,6 +59,9 @@ namespace ui {
 
     void setIcon(HICON_t icon);
 
+    bool killTimer(const UINT_PTR_t id);
+    bool setTimer(const UINT_PTR_t id, const UINT_t milliseconds); // WM_TIMER
+
     virtual LRESULT_t onCommand(WPARAM_t wParam, LPARAM_t lParam); // WM_COMMAND
 
   protected:
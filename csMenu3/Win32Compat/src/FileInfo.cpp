@@ -0,0 +1,224 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>
+
+#include "Win32/FileInfo.h"
+
+namespace fileinfo {
+
+  namespace impl_fileinfo {
+
+    // NOTE: SMB limits a single directory query's response to 64 KiB.
+    constexpr std::size_t LIST_BUFFER_SIZE = 64 * 1024;
+
+    constexpr DWORD SHARE_ALL = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+
+    inline uint64_t toUInt64(const DWORD high, const DWORD low)
+    {
+      return (static_cast<uint64_t>(high) << 32) | static_cast<uint64_t>(low);
+    }
+
+    inline Type toType(const DWORD attributes)
+    {
+      return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0
+             ? Type::Directory
+             : Type::File;
+    }
+
+    inline bool isDotOrDotDot(const std::wstring_view& name)
+    {
+      return name == L"." || name == L"..";
+    }
+
+    bool queryHandle(const wchar_t *filename, const DWORD flags, BY_HANDLE_FILE_INFORMATION& data)
+    {
+      const HANDLE file = CreateFileW(filename, FILE_READ_ATTRIBUTES, SHARE_ALL,
+                                      nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | flags, nullptr);
+      if( file == INVALID_HANDLE_VALUE ) {
+        return false;
+      }
+
+      const BOOL ok = GetFileInformationByHandle(file, &data);
+      CloseHandle(file);
+
+      return ok != FALSE;
+    }
+
+    // "\\?\C:\..." -> "C:\...", "\\?\UNC\server\..." -> "\\server\..."
+    inline std::wstring stripLongPathPrefix(const std::wstring& path)
+    {
+      constexpr std::wstring_view LONG_PREFIX(L"\\\\?\\");
+      constexpr std::wstring_view UNC_PREFIX(L"\\\\?\\UNC\\");
+
+      if( path.starts_with(UNC_PREFIX) ) {
+        return L"\\\\" + path.substr(UNC_PREFIX.size());
+      } else if( path.starts_with(LONG_PREFIX) ) {
+        return path.substr(LONG_PREFIX.size());
+      }
+      return path;
+    }
+
+  } // namespace impl_fileinfo
+
+  Info query(const wchar_t *filename)
+  {
+    using namespace impl_fileinfo;
+
+    if( filename == nullptr ) {
+      return Info{};
+    }
+
+    // (1) The Item Itself; a Link is not Followed ///////////////////////////
+
+    BY_HANDLE_FILE_INFORMATION data;
+    if( !queryHandle(filename, FILE_FLAG_OPEN_REPARSE_POINT, data) ) {
+      return Info{};
+    }
+
+    const DWORD reparsePoint = data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT;
+
+    // (2) Follow a Link to its Target ///////////////////////////////////////
+
+    if( reparsePoint != 0 && !queryHandle(filename, 0, data) ) {
+      return Info{};
+    }
+
+    Info result;
+    result.type       = toType(data.dwFileAttributes);
+    result.attributes = data.dwFileAttributes | reparsePoint;
+    result.size       = toUInt64(data.nFileSizeHigh, data.nFileSizeLow);
+    result.ctime      = toUInt64(data.ftCreationTime.dwHighDateTime, data.ftCreationTime.dwLowDateTime);
+    result.mtime      = toUInt64(data.ftLastWriteTime.dwHighDateTime, data.ftLastWriteTime.dwLowDateTime);
+    result.id         = toUInt64(data.nFileIndexHigh, data.nFileIndexLow);
+
+    return result;
+  }
+
+  std::wstring finalPath(const wchar_t *filename)
+  {
+    using namespace impl_fileinfo;
+
+    if( filename == nullptr ) {
+      return std::wstring{};
+    }
+
+    const HANDLE file = CreateFileW(filename, FILE_READ_ATTRIBUTES, SHARE_ALL,
+                                    nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if( file == INVALID_HANDLE_VALUE ) {
+      return std::wstring{};
+    }
+
+    constexpr DWORD FLAGS = FILE_NAME_NORMALIZED | VOLUME_NAME_DOS;
+
+    std::wstring result;
+    try {
+      result.resize(MAX_PATH, L'\0');
+
+      DWORD length = GetFinalPathNameByHandleW(file, result.data(), static_cast<DWORD>(result.size()), FLAGS);
+      if( length >= result.size() ) { // Too small; length includes the terminating NUL
+        result.resize(length, L'\0');
+        length = GetFinalPathNameByHandleW(file, result.data(), static_cast<DWORD>(result.size()), FLAGS);
+      }
+
+      result.resize(length < result.size() ? length : 0);
+      result = stripLongPathPrefix(result);
+    } catch( ... ) {
+      result.clear();
+    }
+
+    CloseHandle(file);
+
+    return result;
+  }
+
+  bool list(const wchar_t *dirname, const ListFunc& func)
+  {
+    using namespace impl_fileinfo;
+
+    if( dirname == nullptr || !func ) {
+      return false;
+    }
+
+    const HANDLE dir = CreateFileW(dirname, FILE_LIST_DIRECTORY, SHARE_ALL,
+                                   nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if( dir == INVALID_HANDLE_VALUE ) {
+      return false;
+    }
+
+    bool result = true;
+    try {
+      // NOTE: FILE_ID_BOTH_DIR_INFO requires 8-byte alignment.
+      std::vector<uint64_t> buffer(LIST_BUFFER_SIZE / sizeof(uint64_t));
+
+      FILE_INFO_BY_HANDLE_CLASS infoClass = FileIdBothDirectoryRestartInfo;
+      while( GetFileInformationByHandleEx(dir, infoClass, buffer.data(),
+                                          static_cast<DWORD>(LIST_BUFFER_SIZE)) != FALSE ) {
+        infoClass = FileIdBothDirectoryInfo;
+
+        const uint8_t *entry = reinterpret_cast<const uint8_t *>(buffer.data());
+        while( true ) {
+          const FILE_ID_BOTH_DIR_INFO *data = reinterpret_cast<const FILE_ID_BOTH_DIR_INFO *>(entry);
+
+          const std::wstring_view name(data->FileName, data->FileNameLength / sizeof(wchar_t));
+          if( !isDotOrDotDot(name) ) {
+            Info info;
+            info.type       = toType(data->FileAttributes);
+            info.attributes = data->FileAttributes;
+            info.size       = static_cast<uint64_t>(data->EndOfFile.QuadPart);
+            info.ctime      = static_cast<uint64_t>(data->CreationTime.QuadPart);
+            info.mtime      = static_cast<uint64_t>(data->LastWriteTime.QuadPart);
+            info.id         = static_cast<uint64_t>(data->FileId.QuadPart);
+
+            func(name, info);
+          }
+
+          if( data->NextEntryOffset == 0 ) {
+            break;
+          }
+          entry += data->NextEntryOffset;
+        } // For Each Entry
+      } // For Each Query
+
+      result = GetLastError() == ERROR_NO_MORE_FILES;
+    } catch( ... ) {
+      result = false;
+    }
+
+    CloseHandle(dir);
+
+    return result;
+  }
+
+} // namespace fileinfo
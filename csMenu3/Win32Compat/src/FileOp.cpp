@@ -0,0 +1,287 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>
+#include <winternl.h>
+
+#include "Win32/FileOp.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_fileop {
+
+  using NtCreateFile_func = NTSTATUS(NTAPI *)(PHANDLE, ACCESS_MASK, POBJECT_ATTRIBUTES,
+                                              PIO_STATUS_BLOCK, PLARGE_INTEGER, ULONG, ULONG,
+                                              ULONG, ULONG, PVOID, ULONG);
+
+  constexpr DWORD SHARE_ALL = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+
+  // Maximum length of a UNICODE_STRING in characters.
+  constexpr std::size_t MAX_NAME_LENGTH = 0x7FFF;
+
+  // Give up creating a temporary file after this many existing names...
+  constexpr int MAX_TEMPORARY_TRIES = 16;
+
+  constexpr DWORD MAX_WRITE = 1 << 30;
+
+  // Words of a FILE_RENAME_INFO holding a leaf name of up to MAX_PATH characters.
+  constexpr std::size_t RENAME_INFO_WORDS =
+      (offsetof(FILE_RENAME_INFO, FileName) + (MAX_PATH + 1) * sizeof(wchar_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  // Unique per process; the process & thread are part of the name, too.
+  std::atomic<unsigned int> g_numTemporaries{0};
+
+  NtCreateFile_func ntCreateFile()
+  {
+    static const NtCreateFile_func func =
+        reinterpret_cast<NtCreateFile_func>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtCreateFile"));
+    return func;
+  }
+
+  inline bool isLeafName(const std::wstring_view& name)
+  {
+    return !name.empty() && name.size() <= MAX_NAME_LENGTH &&
+        name.find_first_of(L"\\/") == std::wstring_view::npos;
+  }
+
+  // Opens the directory's entry 'name' for renaming; does not follow reparse points.
+  HANDLE openRelative(const HANDLE dir, const std::wstring_view& name)
+  {
+    const NtCreateFile_func func = ntCreateFile();
+    if( func == nullptr ) {
+      return INVALID_HANDLE_VALUE;
+    }
+
+    UNICODE_STRING str;
+    str.Buffer        = const_cast<PWSTR>(name.data());
+    str.Length        = static_cast<USHORT>(name.size() * sizeof(wchar_t));
+    str.MaximumLength = str.Length;
+
+    OBJECT_ATTRIBUTES attr;
+    InitializeObjectAttributes(&attr, &str, OBJ_CASE_INSENSITIVE, dir, nullptr);
+
+    constexpr ULONG OPTIONS = FILE_OPEN_FOR_BACKUP_INTENT | FILE_OPEN_REPARSE_POINT |
+        FILE_SYNCHRONOUS_IO_NONALERT;
+
+    HANDLE file = nullptr;
+    IO_STATUS_BLOCK status;
+    if( func(&file, DELETE | SYNCHRONIZE, &attr, &status, nullptr,
+             0, SHARE_ALL, FILE_OPEN, OPTIONS, nullptr, 0) < 0 ) {
+      return INVALID_HANDLE_VALUE;
+    }
+
+    return file;
+  }
+
+} // namespace impl_fileop
+
+////// Public ////////////////////////////////////////////////////////////////
+
+namespace fileop {
+
+  bool rename(const wchar_t *from, const wchar_t *to)
+  {
+    if( from == nullptr || to == nullptr ) {
+      return false;
+    }
+
+    // NOTE: W/o MOVEFILE_REPLACE_EXISTING, an existing target is an error.
+    return MoveFileExW(from, to, 0) != FALSE;
+  }
+
+  std::wstring writeTemporary(const wchar_t *filename, const std::string_view& data)
+  {
+    using namespace impl_fileop;
+
+    if( filename == nullptr ) {
+      return std::wstring{};
+    }
+
+    std::wstring result;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    try {
+      const std::wstring prefix = std::wstring(filename) + L"." +
+          std::to_wstring(GetCurrentProcessId()) + L"-" + std::to_wstring(GetCurrentThreadId());
+
+      for( int i = 0; i < MAX_TEMPORARY_TRIES && file == INVALID_HANDLE_VALUE; i++ ) {
+        result = prefix + L"-" + std::to_wstring(g_numTemporaries++) + L".tmp";
+
+        // NOTE: CREATE_NEW fails, if the file exists; e.g. a user's file.
+        file = CreateFileW(result.data(), GENERIC_WRITE, 0, nullptr,
+                           CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if( file == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS ) {
+          return std::wstring{};
+        }
+      }
+    } catch( ... ) {
+      if( file != INVALID_HANDLE_VALUE ) {
+        CloseHandle(file);
+        DeleteFileW(result.data());
+      }
+      return std::wstring{};
+    }
+
+    if( file == INVALID_HANDLE_VALUE ) {
+      return std::wstring{};
+    }
+
+    bool ok = true;
+    for( std::size_t pos = 0; ok && pos < data.size(); ) {
+      const DWORD size = static_cast<DWORD>(std::min<std::size_t>(data.size() - pos, MAX_WRITE));
+
+      DWORD numWritten = 0;
+      ok   = WriteFile(file, data.data() + pos, size, &numWritten, nullptr) != FALSE && numWritten > 0;
+      pos += numWritten;
+    }
+
+    CloseHandle(file);
+
+    if( !ok ) {
+      DeleteFileW(result.data());
+      return std::wstring{};
+    }
+
+    return result;
+  }
+
+  Directory::Directory(const wchar_t *dirname) noexcept
+  {
+    using namespace impl_fileop;
+
+    if( dirname == nullptr ) {
+      return;
+    }
+
+    try {
+      _dirname.assign(dirname);
+      if( !_dirname.empty() && _dirname.back() != L'\\' && _dirname.back() != L'/' ) {
+        _dirname.push_back(L'\\');
+      }
+    } catch( ... ) {
+      _dirname.clear();
+      return;
+    }
+
+    const HANDLE dir = CreateFileW(dirname, FILE_TRAVERSE | SYNCHRONIZE, SHARE_ALL,
+                                   nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if( dir != INVALID_HANDLE_VALUE ) {
+      _handle = dir;
+    }
+  }
+
+  Directory::~Directory() noexcept
+  {
+    if( _handle != nullptr ) {
+      CloseHandle(_handle);
+    }
+  }
+
+  bool Directory::isOpen() const
+  {
+    return _handle != nullptr;
+  }
+
+  bool Directory::rename(const std::wstring_view& from, const std::wstring_view& to) const
+  {
+    using namespace impl_fileop;
+
+    if( !isLeafName(from) || !isLeafName(to) ) {
+      return false;
+    }
+
+    if( _dirname.empty() ) {
+      return false;
+    } else if( !isOpen() ) {
+      return fileop::rename(path(from).data(), path(to).data());
+    }
+
+    // (1) Target ////////////////////////////////////////////////////////////
+
+    // NOTE: W/o RootDirectory, a leaf name renames within the same directory.
+
+    const std::size_t sizInfo = std::max<std::size_t>(sizeof(FILE_RENAME_INFO),
+                                                      offsetof(FILE_RENAME_INFO, FileName) +
+                                                      (to.size() + 1) * sizeof(wchar_t));
+    const std::size_t numWords = (sizInfo + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // NOTE: FILE_RENAME_INFO requires pointer alignment; the buffer is local
+    //       to be thread-safe, and on the stack for names up to MAX_PATH.
+    uint64_t local[RENAME_INFO_WORDS];
+    std::vector<uint64_t> heap;
+    uint64_t *buffer = local;
+    if( numWords > RENAME_INFO_WORDS ) {
+      try {
+        heap.resize(numWords);
+      } catch( ... ) {
+        return false;
+      }
+      buffer = heap.data();
+    }
+
+    FILE_RENAME_INFO *info = reinterpret_cast<FILE_RENAME_INFO *>(buffer);
+    info->ReplaceIfExists  = FALSE;
+    info->RootDirectory    = nullptr;
+    info->FileNameLength   = static_cast<DWORD>(to.size() * sizeof(wchar_t));
+    std::copy(to.begin(), to.end(), info->FileName);
+    info->FileName[to.size()] = L'\0';
+
+    // (2) Rename ////////////////////////////////////////////////////////////
+
+    const HANDLE file = openRelative(_handle, from);
+    if( file == INVALID_HANDLE_VALUE ) {
+      return false;
+    }
+
+    const BOOL ok = SetFileInformationByHandle(file, FileRenameInfo, info, static_cast<DWORD>(sizInfo));
+    CloseHandle(file);
+
+    return ok != FALSE;
+  }
+
+  std::wstring Directory::path(const std::wstring_view& name) const
+  {
+    try {
+      std::wstring result(_dirname);
+      result.append(name);
+      return result;
+    } catch( ... ) {
+    }
+    return std::wstring{};
+  }
+
+} // namespace fileop
@@ -41,30 +41,36 @@ std::wstring resolveUniversalName(const wchar_t *filename)
 {
   using Buffer = std::vector<uint8_t>;
 
-  UNIVERSAL_NAME_INFOW info;
-  DWORD sizInfo = sizeof(info);
-  if( WNetGetUniversalNameW(filename, UNIVERSAL_NAME_INFO_LEVEL,
-                            &info, &sizInfo)
-      != ERROR_MORE_DATA ) {
-    return std::wstring{};
-  }
-  sizInfo += sizeof(wchar_t);
+  // Most names fit; only retry if the provider asks for more...
+  constexpr DWORD INITIAL_SIZE = 1024;
 
   Buffer buffer;
   try {
-    buffer.resize(sizInfo, 0);
+    buffer.resize(INITIAL_SIZE, 0);
   } catch( ... ) {
     return std::wstring{};
   }
 
-  if( WNetGetUniversalNameW(filename, UNIVERSAL_NAME_INFO_LEVEL,
-                            buffer.data(), &sizInfo)
-      != NO_ERROR ) {
+  DWORD sizInfo = static_cast<DWORD>(buffer.size());
+  DWORD result  = WNetGetUniversalNameW(filename, UNIVERSAL_NAME_INFO_LEVEL,
+                                        buffer.data(), &sizInfo);
+  if( result == ERROR_MORE_DATA ) {
+    sizInfo += sizeof(wchar_t);
+
+    try {
+      buffer.resize(sizInfo, 0);
+    } catch( ... ) {
+      return std::wstring{};
+    }
+
+    result = WNetGetUniversalNameW(filename, UNIVERSAL_NAME_INFO_LEVEL,
+                                   buffer.data(), &sizInfo);
+  }
+
+  if( result != NO_ERROR ) {
     return std::wstring{};
   }
 
   const UNIVERSAL_NAME_INFOW *ptrInfo = reinterpret_cast<const UNIVERSAL_NAME_INFOW *>(buffer.data());
-  const std::wstring result{ptrInfo->lpUniversalName};
-
-  return result;
+  return std::wstring{ptrInfo->lpUniversalName};
 }
@@ -30,12 +30,122 @@
 *****************************************************************************/
 
 #include <cstring>
+#include <cwchar>
+#include <cwctype>
 
 #include <ShlObj.h>
+#include <Shlwapi.h>
 #include <Windows.h>
 
 #include "Win32/Shell.h"
 
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_shell {
+
+  // cf. CreateProcess()
+  constexpr std::size_t MAX_COMMAND_LINE = 32767;
+
+  // Unresolved programs' command lines are unknown; reserve room for the
+  // interpreter & its switches...
+  constexpr std::size_t UNRESOLVED_RESERVE = 1024;
+
+  constexpr std::size_t NPOS = std::wstring::npos;
+
+  std::wstring lowerExtension(const std::wstring& filename)
+  {
+    const std::size_t posDot = filename.rfind(L'.');
+    const std::size_t posSep = filename.find_last_of(L"\\/");
+    if( posDot == NPOS || (posSep != NPOS && posDot < posSep) ) {
+      return std::wstring{};
+    }
+
+    std::wstring result = filename.substr(posDot);
+    for( wchar_t& ch : result ) {
+      ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+
+    return result;
+  }
+
+  std::wstring quoted(const std::wstring& text)
+  {
+    return L"\"" + text + L"\"";
+  }
+
+  std::wstring association(const std::wstring& extension)
+  {
+    DWORD size = 0;
+    if( AssocQueryStringW(ASSOCF_INIT_IGNOREUNKNOWN, ASSOCSTR_COMMAND, extension.data(), L"open",
+                          nullptr, &size) != S_FALSE || size < 1 ) {
+      return std::wstring{};
+    }
+
+    std::wstring result(size, L'\0');
+    if( AssocQueryStringW(ASSOCF_INIT_IGNOREUNKNOWN, ASSOCSTR_COMMAND, extension.data(), L"open",
+                          result.data(), &size) != S_OK ) {
+      return std::wstring{};
+    }
+    result.resize(size > 0 ? size - 1 : 0); // size includes the terminating NUL
+
+    return result;
+  }
+
+  std::wstring expandEnvironment(const std::wstring& text)
+  {
+    const DWORD size = ExpandEnvironmentStringsW(text.data(), nullptr, 0);
+    if( size < 1 ) {
+      return std::wstring{};
+    }
+
+    std::wstring result(size, L'\0');
+    if( ExpandEnvironmentStringsW(text.data(), result.data(), size) != size ) {
+      return std::wstring{};
+    }
+    result.resize(size - 1);
+
+    return result;
+  }
+
+  // Full path of the command line's first token; searches the PATH.
+  std::wstring applicationName(const std::wstring& command)
+  {
+    std::wstring name;
+    if( command.starts_with(L'"') ) {
+      const std::size_t posQuote = command.find(L'"', 1);
+      if( posQuote == NPOS ) {
+        return std::wstring{};
+      }
+      name = command.substr(1, posQuote - 1);
+    } else {
+      name = command.substr(0, command.find_first_of(L" \t"));
+    }
+
+    std::wstring result(MAX_PATH, L'\0');
+    DWORD length = SearchPathW(nullptr, name.data(), L".exe",
+                               static_cast<DWORD>(result.size()), result.data(), nullptr);
+    if( length >= result.size() ) { // Too small; length includes the terminating NUL
+      result.resize(length, L'\0');
+      length = SearchPathW(nullptr, name.data(), L".exe",
+                           static_cast<DWORD>(result.size()), result.data(), nullptr);
+    }
+    result.resize(length < result.size() ? length : 0);
+
+    return result;
+  }
+
+  std::wstring commandInterpreter()
+  {
+    const std::wstring comspec = expandEnvironment(L"%ComSpec%");
+    return !comspec.empty() && comspec != L"%ComSpec%"
+           ? comspec
+           : applicationName(L"cmd.exe");
+  }
+
+} // namespace impl_shell
+
+////// Public ////////////////////////////////////////////////////////////////
+
 namespace shell {
 
   void execute(const wchar_t *executable, const wchar_t *arguments, const wchar_t *directory)
@@ -66,4 +176,170 @@ namespace shell {
     SHChangeNotify(SHCNE_ASSOCCHANGED, SHCNF_IDLIST, NULL, NULL);
   }
 
+  Launcher::Launcher(const wchar_t *program) noexcept
+  {
+    if( program == nullptr ) {
+      return;
+    }
+
+    try {
+      _program.assign(program);
+      if( !resolve() ) {
+        _application.clear();
+      }
+    } catch( ... ) {
+      _application.clear();
+    }
+  }
+
+  Launcher::~Launcher() noexcept
+  {
+  }
+
+  bool Launcher::isResolved() const
+  {
+    return !_application.empty();
+  }
+
+  std::size_t Launcher::maxArguments() const
+  {
+    using namespace impl_shell;
+
+    const std::size_t reserved = isResolved()
+                                 ? _prefix.size() + _suffix.size()
+                                 : _program.size() + 3 + UNRESOLVED_RESERVE; // Quoted & space
+    return !_program.empty() && reserved < MAX_COMMAND_LINE - 1
+           ? MAX_COMMAND_LINE - 1 - reserved
+           : 0;
+  }
+
+  bool Launcher::execute(const wchar_t *arguments) const
+  {
+    using namespace impl_shell;
+
+    if( _program.empty() ) {
+      return false;
+    } else if( !isResolved() ) {
+      shell::execute(_program.data(), arguments);
+      return true;
+    }
+
+    std::wstring command;
+    try {
+      const std::size_t sizArgs = arguments != nullptr ? std::wcslen(arguments) : 0;
+      command.reserve(_prefix.size() + sizArgs + _suffix.size());
+
+      command  = _prefix;
+      command.append(arguments != nullptr ? arguments : L"", sizArgs);
+      command += _suffix;
+    } catch( ... ) {
+      return false;
+    }
+
+    if( command.size() >= MAX_COMMAND_LINE ) {
+      return false;
+    }
+
+    STARTUPINFOW si;
+    std::memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+
+    PROCESS_INFORMATION pi;
+    std::memset(&pi, 0, sizeof(pi));
+
+    // NOTE: The environment is only read, albeit declared as non-const.
+    void *environment = const_cast<wchar_t *>(_environment.data());
+
+    constexpr DWORD FLAGS = CREATE_DEFAULT_ERROR_MODE | CREATE_UNICODE_ENVIRONMENT;
+    if( CreateProcessW(_application.data(), command.data(), nullptr, nullptr, FALSE,
+                       FLAGS, environment, nullptr, &si, &pi) == FALSE ) {
+      return false;
+    }
+
+    CloseHandle(pi.hThread);
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    CloseHandle(pi.hProcess);
+
+    return true;
+  }
+
+  bool Launcher::resolve()
+  {
+    using namespace impl_shell;
+
+    const std::wstring extension = lowerExtension(_program);
+
+    // (1) Executables, batch files & associations ///////////////////////////
+
+    if( extension == L".exe" || extension == L".com" ) {
+      _application = _program;
+      _prefix      = quoted(_program) + L" ";
+    } else if( extension == L".bat" || extension == L".cmd" ) {
+      // NOTE: "/s /c" strips the outer quotes only; cf. "cmd /?".
+      _application = commandInterpreter();
+      _prefix      = quoted(_application) + L" /d /s /c \"" + quoted(_program) + L" ";
+      _suffix      = L"\"";
+    } else {
+      const std::wstring command = expandEnvironment(association(extension));
+
+      // Substitute the program; split at the arguments ("%*").
+      std::size_t posArgs = NPOS;
+      std::wstring resolved;
+      for( std::size_t i = 0; i < command.size(); i++ ) {
+        if( command[i] != L'%' ) {
+          resolved.push_back(command[i]);
+          continue;
+        }
+
+        const wchar_t ch = i + 1 < command.size() ? command[++i] : L'\0';
+        if( ch == L'1' || ch == L'L' || ch == L'l' ) {
+          resolved += _program;
+        } else if( ch == L'*' && posArgs == NPOS ) {
+          posArgs = resolved.size();
+        } else {
+          return false; // Unsupported placeholder or unexpanded variable
+        }
+      }
+
+      if( posArgs == NPOS ) {
+        return false;
+      }
+
+      _application = applicationName(resolved);
+      _prefix      = resolved.substr(0, posArgs);
+      _suffix      = resolved.substr(posArgs);
+    }
+
+    if( _application.empty() ) {
+      return false;
+    }
+
+    // (2) Environment ///////////////////////////////////////////////////////
+
+    wchar_t *strings = GetEnvironmentStringsW();
+    if( strings == nullptr ) {
+      return false;
+    }
+
+    const wchar_t *first = strings;
+    const wchar_t *last  = strings;
+    while( *last != L'\0' ) { // Double NUL terminated
+      last += std::wcslen(last) + 1;
+    }
+
+    bool result = true;
+    try {
+      _environment.assign(first, last + 1);
+      if( _environment.size() < 2 ) { // Empty
+        _environment.assign(2, L'\0');
+      }
+    } catch( ... ) {
+      result = false;
+    }
+
+    FreeEnvironmentStringsW(strings);
+
+    return result;
+  }
+
 } // namespace shell
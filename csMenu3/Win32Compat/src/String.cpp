@@ -29,6 +29,10 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>
 #include <strsafe.h>
 
 #include "Win32/String.h"
@@ -49,3 +53,99 @@ std::size_t StringLength(const wchar_t *str, const std::size_t max)
 
   return length;
 }
+
+bool StringToUpper(wchar_t *dest, const wchar_t *src, const std::size_t length)
+{
+  if( dest == nullptr || src == nullptr || length > MAX_STRLEN ) {
+    return false;
+  }
+
+  if( length < 1 ) {
+    return true;
+  }
+
+  const int size = static_cast<int>(length);
+
+  return LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE,
+                       src, size, dest, size, nullptr, nullptr, 0) == size;
+}
+
+bool StringToLower(wchar_t *dest, const wchar_t *src, const std::size_t length)
+{
+  if( dest == nullptr || src == nullptr || length > MAX_STRLEN ) {
+    return false;
+  }
+
+  if( length < 1 ) {
+    return true;
+  }
+
+  const int size = static_cast<int>(length);
+
+  return LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_LOWERCASE,
+                       src, size, dest, size, nullptr, nullptr, 0) == size;
+}
+
+/*
+ * NOTE: The sort key's bytes are packed into characters, most significant
+ *       first; its terminating NUL is dropped. As only the terminator is
+ *       zero, no character is below U+0100.
+ */
+
+bool StringSortKey(std::wstring& key, const wchar_t *str, const std::size_t length)
+{
+  constexpr DWORD FLAGS      = LCMAP_SORTKEY | NORM_IGNORECASE | SORT_DIGITSASNUMBERS;
+  constexpr int   SIZE_LOCAL = 512;
+
+  if( str == nullptr || length > MAX_STRLEN ) {
+    return false;
+  }
+
+  if( length < 1 ) {
+    return true;
+  }
+
+  const int len = static_cast<int>(length);
+
+  BYTE local[SIZE_LOCAL];
+  std::vector<BYTE> heap;
+  BYTE *bytes = local;
+
+  int size = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, FLAGS, str, len,
+                           reinterpret_cast<LPWSTR>(bytes), SIZE_LOCAL, nullptr, nullptr, 0);
+  if( size < 1 ) {
+    size = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, FLAGS, str, len,
+                         nullptr, 0, nullptr, nullptr, 0);
+    if( size < 1 ) {
+      return false;
+    }
+
+    try {
+      heap.resize(static_cast<std::size_t>(size));
+    } catch( ... ) {
+      return false;
+    }
+    bytes = heap.data();
+
+    size = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, FLAGS, str, len,
+                         reinterpret_cast<LPWSTR>(bytes), size, nullptr, nullptr, 0);
+    if( size < 1 ) {
+      return false;
+    }
+  }
+  size--; // Terminating NUL
+
+  try {
+    for( int i = 0; i < size; i += 2 ) {
+      const wchar_t hi = static_cast<wchar_t>(bytes[i]);
+      const wchar_t lo = i + 1 < size
+                         ? static_cast<wchar_t>(bytes[i + 1])
+                         : 0;
+      key.push_back(static_cast<wchar_t>((hi << 8) | lo));
+    }
+  } catch( ... ) {
+    return false;
+  }
+
+  return true;
+}
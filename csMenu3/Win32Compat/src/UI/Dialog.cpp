@@ -68,7 +68,24 @@ namespace ui {
       }
       break; // WM_COMMAND
 
+    case WM_NOTIFY:
+      if( ui != nullptr ) {
+        // NOTE: A dialog procedure returns a notification's result via DWLP_MSGRESULT.
+        SetWindowLongPtrW(hWnd, DWLP_MSGRESULT, ui->onNotify(wParam, lParam));
+        return TRUE;
+      }
+      break; // WM_NOTIFY
+
+    case WM_TIMER:
+      if( ui != nullptr ) {
+        return ui->onTimer(wParam, lParam);
+      }
+      break; // WM_TIMER
+
     default:
+      if( ui != nullptr && uMsg >= DIALOG_USER && uMsg <= DIALOG_USER_LAST ) {
+        return ui->onUser(uMsg, wParam, lParam);
+      }
       break;
     }
 
@@ -113,6 +130,21 @@ namespace ui {
     return FALSE;
   }
 
+  LRESULT_t Dialog::onNotify(WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
+  {
+    return FALSE;
+  }
+
+  LRESULT_t Dialog::onTimer(WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
+  {
+    return FALSE;
+  }
+
+  LRESULT_t Dialog::onUser(UINT_t /*msg*/, WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
+  {
+    return FALSE;
+  }
+
   bool Dialog::exec(HINSTANCE_t instance, HWND_t parent)
   {
     if( !registerWindowClass(instance, wndClassName(), iconName()) ) {
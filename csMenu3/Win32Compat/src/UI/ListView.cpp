@@ -0,0 +1,118 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <Windows.h>
+#include <CommCtrl.h>
+
+#include "Win32/UI/ListView.h"
+
+namespace ui {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  ListView::ListView(HWND_t wnd, const ctor_tag&) noexcept
+    : Window(wnd)
+  {
+  }
+
+  ListView::ListView(HWND_t dlg, int idDlgItem, const ctor_tag&) noexcept
+    : Window(dlg, idDlgItem)
+  {
+  }
+
+  ListView::~ListView() noexcept
+  {
+  }
+
+  bool ListView::insertColumn(const int index, const std::wstring& title, const int width)
+  {
+    LVCOLUMNW column;
+    column.mask    = LVCF_TEXT | LVCF_WIDTH;
+    column.cx      = width;
+    column.pszText = const_cast<wchar_t *>(title.data());
+
+    return sendMessage(LVM_INSERTCOLUMNW, index, reinterpret_cast<LPARAM_t>(&column)) >= 0;
+  }
+
+  bool ListView::redrawItems(const int first, const int last)
+  {
+    return sendMessage(LVM_REDRAWITEMS, first, last) != FALSE;
+  }
+
+  void ListView::redrawAll()
+  {
+    InvalidateRect(reinterpret_cast<HWND>(handle()), nullptr, FALSE);
+  }
+
+  void ListView::setFullRowSelect(const bool on)
+  {
+    const LPARAM_t style = on
+                           ? LVS_EX_FULLROWSELECT
+                           : 0;
+    sendMessage(LVM_SETEXTENDEDLISTVIEWSTYLE, LVS_EX_FULLROWSELECT, style);
+  }
+
+  bool ListView::setItemCount(const int count)
+  {
+    // NOTE: Keep the scroll position, e.g. while the items' texts change.
+    return sendMessage(LVM_SETITEMCOUNT, count, LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL) != FALSE;
+  }
+
+  int ListView::width() const
+  {
+    RECT rect;
+    if( GetClientRect(reinterpret_cast<HWND>(handle()), &rect) == FALSE ) {
+      return 0;
+    }
+    return rect.right - rect.left;
+  }
+
+  ////// public static /////////////////////////////////////////////////////
+
+  bool ListView::initialize()
+  {
+    INITCOMMONCONTROLSEX iccex;
+    iccex.dwSize = sizeof(iccex);
+    iccex.dwICC  = ICC_LISTVIEW_CLASSES;
+    return InitCommonControlsEx(&iccex) != FALSE;
+  }
+
+  WindowPtr ListView::create(HWND_t wnd)
+  {
+    return std::make_unique<ListView>(wnd);
+  }
+
+  WindowPtr ListView::create(HWND_t dlg, int idDlgItem)
+  {
+    return std::make_unique<ListView>(dlg, idDlgItem);
+  }
+
+} // namespace ui
@@ -61,6 +61,11 @@ namespace ui {
     return GetDlgCtrlID(reinterpret_cast<HWND>(_wnd));
   }
 
+  bool Window::postMessage(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam) const
+  {
+    return PostMessageW(reinterpret_cast<HWND>(_wnd), msg, wParam, lParam) != FALSE;
+  }
+
   LRESULT_t Window::sendMessage(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam) const
   {
     return SendMessageW(reinterpret_cast<HWND>(_wnd), msg, wParam, lParam);
@@ -81,6 +86,16 @@ namespace ui {
     SetWindowLongPtrW(reinterpret_cast<HWND>(_wnd), GCLP_HICON, reinterpret_cast<LONG_PTR>(icon));
   }
 
+  bool Window::killTimer(const UINT_PTR_t id)
+  {
+    return KillTimer(reinterpret_cast<HWND>(_wnd), id) != FALSE;
+  }
+
+  bool Window::setTimer(const UINT_PTR_t id, const UINT_t milliseconds)
+  {
+    return SetTimer(reinterpret_cast<HWND>(_wnd), id, milliseconds, nullptr) != 0;
+  }
+
   LRESULT_t Window::onCommand(WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
   {
     return FALSE;
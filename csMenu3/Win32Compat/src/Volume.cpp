@@ -0,0 +1,121 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <format>
+
+#define NOMINMAX
+#include <Windows.h>
+
+#include "Win32/Volume.h"
+
+namespace volume {
+
+  namespace impl_volume {
+
+    // NOTE: VirtualAlloc()'ed buffers are aligned to the allocation granularity (64 KiB).
+    constexpr uint64_t ALIGNMENT = 64 * 1024;
+
+  } // namespace impl_volume
+
+  std::wstring identifier(const wchar_t *filename)
+  {
+    constexpr DWORD MAX_LENGTH = MAX_PATH + 1;
+
+    if( filename == nullptr ) {
+      return std::wstring{};
+    }
+
+    wchar_t root[MAX_LENGTH];
+    if( GetVolumePathNameW(filename, root, MAX_LENGTH) == FALSE ) {
+      return std::wstring{};
+    }
+
+    DWORD serial = 0;
+    if( GetVolumeInformationW(root, nullptr, 0, &serial, nullptr, nullptr, nullptr, 0) == FALSE ) {
+      return std::wstring{};
+    }
+
+    std::wstring result;
+    try {
+      result = std::format(L"{:08X}", serial);
+    } catch( ... ) {
+      result.clear();
+    }
+
+    return result;
+  }
+
+  uint64_t readUncached(const wchar_t *filename, const uint64_t offset,
+                        const std::size_t sizBlock, const uint64_t maxBytes)
+  {
+    if( filename == nullptr
+        || sizBlock < 1 || sizBlock % impl_volume::ALIGNMENT != 0 || sizBlock > MAXDWORD ) {
+      return 0;
+    }
+
+    const HANDLE file = CreateFileW(filename, GENERIC_READ,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if( file == INVALID_HANDLE_VALUE ) {
+      return 0;
+    }
+
+    void *buffer = VirtualAlloc(nullptr, sizBlock, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if( buffer == nullptr ) {
+      CloseHandle(file);
+      return 0;
+    }
+
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(offset - offset % impl_volume::ALIGNMENT);
+
+    uint64_t numTotal = 0;
+    if( SetFilePointerEx(file, position, nullptr, FILE_BEGIN) != FALSE ) {
+      DWORD numRead = 0;
+      while( numTotal < maxBytes
+             && ReadFile(file, buffer, static_cast<DWORD>(sizBlock), &numRead, nullptr) != FALSE
+             && numRead > 0 ) {
+        numTotal += numRead;
+
+        if( numRead < sizBlock ) { // EOF
+          break;
+        }
+      } // For Each Block
+    }
+
+    VirtualFree(buffer, 0, MEM_RELEASE);
+    CloseHandle(file);
+
+    return numTotal;
+  }
+
+} // namespace volume
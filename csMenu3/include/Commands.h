@@ -43,11 +43,18 @@ enum class Command : CommandId {
   List,
   ListPath,
   ListPathTabular,
+  ListCanonical,
+  ListDetailedCsv,
+  ListDetailedTsv,
+  ListDetailedJson,
+  ListTree,
   Rename,
   CheckBatchProcessing,
   CheckParallelExecution,
   CheckResolveUncPaths,
   CheckUnixPathSeparators,
+  CheckHashSidecarFiles,
+  CalibrateStorage,
   HashMenu,
   HashCrc32,
   HashMd5,
@@ -56,6 +63,9 @@ enum class Command : CommandId {
   HashSha256,
   HashSha384,
   HashSha512,
+  HashXxh3_64,
+  HashXxh3_128,
+  HashFingerprint,
   ScriptMenu,
   Num_Commands
 };
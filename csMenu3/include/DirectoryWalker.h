@@ -0,0 +1,64 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <cs/System/FileSystem.h>
+
+#include "Win32/FileInfo.h"
+
+struct WalkEntry {
+  std::wstring filename{};
+  fileinfo::Info info{};
+};
+
+using WalkFunc = std::function<void(const WalkEntry& entry)>;
+
+/*
+ * NOTE: Walks the roots' directory trees with numThreads threads; each thread
+ *       works depth-first on its own queue of directories and steals the
+ *       oldest (i.e. shallowest) directories of other threads when idle.
+ *       Directories are read in bulk, their entries' attributes included.
+ *
+ *       Nonetheless, func is called on the calling thread and in order:
+ *       Each root is followed by its contents, depth-first, each directory's
+ *       entries in natural order (cf. SortKey.h). Entries are passed as
+ *       soon as all preceding entries are, i.e. while the walk is still in
+ *       progress.
+ *
+ *       Reparse points (e.g. junctions & symbolic links) are not followed.
+ *       Returns false, if any directory could not be read completely.
+ */
+
+bool walkDirectories(const cs::PathList& roots, const std::size_t numThreads, const WalkFunc& func);
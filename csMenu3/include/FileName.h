@@ -31,8 +31,43 @@
 
 #pragma once
 
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
 #include <cs/System/FileSystem.h>
 
-std::wstring joinFileNames(const cs::PathList& files);
+/*
+ * NOTE: Paths are handled in their native encoding, i.e. UTF-16 on Windows;
+ *       conversions are left to the UI & clipboard boundary.
+ */
+
+using NativeChar   = std::filesystem::path::value_type;
+using NativeString = std::filesystem::path::string_type;
+
+using NativeStrings = std::vector<NativeString>;
+
+// Append ASCII text, e.g. a hex digest, w/o an intermediate conversion.
+template <typename CharT>
+inline void appendAscii(std::basic_string<CharT>& result, const std::string_view& ascii)
+{
+  const std::size_t pos = result.size();
+  result.resize(pos + ascii.size());
+  std::copy(ascii.begin(), ascii.end(), result.begin() + pos);
+}
+
+// Append the filename, quoted if it contains spaces.
+void appendFileName(NativeString& result, const std::filesystem::path& filename);
+
+// Filenames compare case-insensitively, e.g. on NTFS or SMB; cf. RenamePlan.
+std::wstring foldFileName(const std::wstring_view& filename);
+
+// Split the files into batches, joined like joinFileNames(), of at most
+// maxLength characters & maxFiles files (0 == unlimited); cf. xargs.
+// A filename exceeding maxLength forms a batch of its own.
+NativeStrings batchFileNames(const cs::PathList& files,
+                             const std::size_t maxLength, const std::size_t maxFiles = 0);
+
+NativeString joinFileNames(const cs::PathList& files);
 
-std::wstring quotedFileName(const std::wstring& filename);
+NativeString quotedFileName(const std::filesystem::path& filename);
@@ -0,0 +1,88 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <cs/System/FileSystem.h>
+
+#include "Selection.h"
+#include "Win32/FileInfo.h"
+
+/*
+ * NOTE: A FileSnapshot captures the attributes of an invocation's selection
+ *       up front: Directories with many selected entries are listed in one
+ *       go, all other entries are queried in parallel. Anything else is
+ *       queried on first use and then cached, too.
+ *
+ *       A snapshot is never refreshed; it lives as long as its invocation.
+ */
+
+using FileSnapshotPtr = std::shared_ptr<const class FileSnapshot>;
+
+class FileSnapshot {
+private:
+  struct ctor_tag {
+    ctor_tag() noexcept;
+  };
+
+public:
+  FileSnapshot(const ctor_tag&) noexcept;
+  ~FileSnapshot() noexcept;
+
+  fileinfo::Info info(const std::filesystem::path& filename) const;
+  fileinfo::Info info(const std::wstring& filename) const;
+
+  bool isDirectory(const std::filesystem::path& filename) const;
+  bool isFile(const std::filesystem::path& filename) const;
+
+  uint64_t size(const std::filesystem::path& filename) const;
+
+  // Equivalent to cs::filter(input, cs::PathListFlag::File).
+  cs::PathList files(const cs::PathList& input) const;
+
+  static FileSnapshotPtr make(const Selection& selection);
+
+private:
+  using Infos = std::unordered_map<std::wstring, fileinfo::Info>;
+
+  void capture(const Selection& selection);
+
+  mutable std::mutex _mutex{};
+  mutable Infos _infos{};
+};
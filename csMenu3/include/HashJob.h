@@ -0,0 +1,75 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cs/System/FileSystem.h>
+
+#include "FileSnapshot.h"
+#include "HashFunction.h"
+
+/*
+ * NOTE: A HashJob registers its files with a process-wide registry for the
+ *       lifetime of the job. Concurrent jobs using the same algorithm on
+ *       the same (or overlapping) files share one computation per file:
+ *       Whoever asks first computes, everyone else waits for the result.
+ *
+ *       A file is identified by its path, size & last write time, as taken
+ *       from the job's snapshot (if any); i.e. a job never shares another
+ *       job's computation over a since modified file.
+ */
+
+class HashJob {
+public:
+  using Compute = std::function<std::string()>;
+
+  HashJob(const HashFunction func, const cs::PathList& files,
+          const FileSnapshotPtr& snapshot = FileSnapshotPtr{}) noexcept;
+  ~HashJob() noexcept;
+
+  std::string digest(const std::filesystem::path& filename, const Compute& compute) const;
+
+private:
+  HashJob() noexcept = delete;
+  HashJob(const HashJob&) noexcept = delete;
+  HashJob& operator=(const HashJob&) noexcept = delete;
+
+  std::wstring key(const std::filesystem::path& filename) const;
+
+  HashFunction _func{HashFunction::Invalid};
+  FileSnapshotPtr _snapshot{};
+  std::vector<std::wstring> _keys{};
+};
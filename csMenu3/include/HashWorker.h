@@ -31,8 +31,14 @@
 
 #pragma once
 
-#include <cs/Crypto/Hash.h>
-
+#include "HashFunction.h"
 #include "WorkContext.h"
 
-void hash_work(const cs::Hash::Function func, WorkContext ctx);
+enum class HashOutput : unsigned {
+  Clipboard = 0,
+  Sidecar // One "<file>.<algorithm>" per file
+};
+
+void fingerprint_work(WorkContext ctx);
+
+void hash_work(const HashFunction func, const HashOutput output, WorkContext ctx);
@@ -31,9 +31,8 @@
 
 #pragma once
 
-#include <cs/System/FileSystem.h>
-
 #include "Commands.h"
+#include "Selection.h"
 
 void invokeCommandId(const CommandId id, const std::wstring& script = std::wstring{},
-                     const cs::PathList& selection = cs::PathList{});
+                     const Selection& selection = Selection{});
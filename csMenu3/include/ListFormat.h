@@ -0,0 +1,61 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Commands.h"
+#include "Win32/FileInfo.h"
+
+struct ListItem {
+  std::wstring filename{};
+  bool is_directory{false};
+  fileinfo::Info info{}; // Detailed listings only
+};
+
+using ListItems = std::vector<ListItem>;
+
+/*
+ * NOTE: Formats the List commands' text in a single pass: The output's size
+ *       is computed exactly beforehand, separators are translated while
+ *       copying. Each combination of command & separator style is a
+ *       separate instantiation.
+ *
+ *       Every line is terminated by EOL, unless there is only one item.
+ *       Canonical paths and a tree's items are formatted like List (path).
+ *
+ *       Detailed listings (CSV, TSV & JSON) always start with a header and
+ *       print one record per item; timestamps are ISO 8601 (UTC).
+ */
+
+std::wstring formatList(const CommandId id, const ListItems& items, const bool is_unix);
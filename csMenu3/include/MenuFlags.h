@@ -40,7 +40,8 @@ enum class MenuFlag : DWORD_t {
   BatchProcessing = 1,
   ParallelExecution = 2,
   ResolveUncPaths = 4,
-  UnixPathSeparators = 8
+  UnixPathSeparators = 8,
+  HashSidecarFiles = 16
 };
 
 CS_ENABLE_FLAGS(MenuFlag);
@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * NOTE: A MultiReplace compiles a list of patterns into one Aho-Corasick
+ *       automaton, i.e. a DFA over the characters occurring in any pattern;
+ *       all patterns are then substituted in a single pass over the input.
+ *       Matches do not overlap; the leftmost, then longest pattern wins.
+ *
+ *       Syntax: Patterns and replacements are separated by '|', which is
+ *       invalid in filenames. A single replacement applies to all patterns;
+ *       otherwise, there is one replacement per pattern. An empty pattern
+ *       is ignored. A leading "(?i)" ignores case.
+ *
+ *       Matching uses (mutable) scratch memory; hence a MultiReplace must
+ *       not be shared between threads; copy it instead.
+ */
+
+class MultiReplace {
+public:
+  static constexpr wchar_t SEPARATOR = L'|';
+
+  MultiReplace() noexcept;
+  MultiReplace(const std::wstring_view& patterns,
+               const std::wstring_view& replaces = std::wstring_view()) noexcept;
+  ~MultiReplace() noexcept;
+
+  bool isValid() const;
+
+  std::size_t numPatterns() const;
+
+  // Appends input to result, with all matches substituted by their replacement.
+  bool replaceAll(std::wstring& result, const std::wstring_view& input) const;
+
+private:
+  struct CharClass {
+    wchar_t ch{0};
+    uint32_t id{0};
+  };
+
+  bool compile(const std::vector<std::wstring_view>& patterns);
+  uint32_t classOf(const wchar_t ch) const;
+
+  // Characters & their classes; class 0 is any character not in a pattern.
+  std::vector<uint32_t> _asciiClasses{};
+  std::vector<CharClass> _otherClasses{};
+  std::size_t _numClasses{0};
+
+  // Per state: Transitions, depth in the trie & longest matching pattern.
+  std::vector<uint32_t> _delta{};
+  std::vector<uint32_t> _depth{};
+  std::vector<uint32_t> _match{};
+
+  // Per pattern.
+  std::vector<std::size_t> _lengths{};
+  std::vector<std::wstring> _replaces{};
+
+  bool _isCaseInsensitive{false};
+
+  mutable std::wstring _folded{};
+};
@@ -0,0 +1,91 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/*
+ * NOTE: Sorts each of numThreads chunks concurrently, then merges neighbouring
+ *       chunks pairwise and concurrently, until a single run remains; cf.
+ *       ThreadPool::forEach(). Small ranges are sorted on the calling thread.
+ */
+
+inline constexpr std::size_t PARALLEL_SORT_MIN_CHUNK = 16 * 1024;
+
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, std::size_t numThreads)
+{
+  const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+
+  numThreads = std::min(numThreads, count / PARALLEL_SORT_MIN_CHUNK);
+  if( numThreads < 2 ) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  // (1) Sort Chunks /////////////////////////////////////////////////////////
+
+  std::vector<RandomIt> bounds;
+  for( std::size_t i = 0; i < numThreads; i++ ) {
+    bounds.push_back(first + (count * i) / numThreads);
+  }
+  bounds.push_back(last);
+
+  ThreadPool::instance().forEach(numThreads, numThreads, [&](const std::size_t i) -> void {
+    std::sort(bounds[i], bounds[i + 1], comp);
+  });
+
+  // (2) Merge Chunks Pairwise ///////////////////////////////////////////////
+
+  while( bounds.size() > 2 ) {
+    const std::size_t numMerges = (bounds.size() - 1) / 2;
+
+    ThreadPool::instance().forEach(numMerges, numThreads, [&](const std::size_t i) -> void {
+      std::inplace_merge(bounds[2*i], bounds[2*i + 1], bounds[2*i + 2], comp);
+    });
+
+    std::vector<RandomIt> merged;
+    std::size_t i = 0;
+    for( ; i < 2*numMerges; i += 2 ) {
+      merged.push_back(bounds[i]);
+    }
+    for( ; i < bounds.size(); i++ ) { // Odd chunk & end
+      merged.push_back(bounds[i]);
+    }
+
+    bounds = std::move(merged);
+  }
+}
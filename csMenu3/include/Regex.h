@@ -0,0 +1,154 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * NOTE: A Regex is compiled once into the program of a Pike VM, i.e. a
+ *       simulated NFA that tracks capture groups. Matching never backtracks
+ *       and takes time linear in the length of the input.
+ *
+ *       Syntax: Literals, '.', classes ([a-z], [^...]), escapes (\d, \s, \w
+ *       and their negations, any escaped punctuation), anchors (^, $),
+ *       groups ("(...)", "(?:...)"), alternation (|) and greedy or lazy
+ *       quantifiers (*, +, ?, {m}, {m,}, {m,n}). A leading "(?i)" ignores
+ *       case.
+ *
+ *       The replacement references groups by "$n" or "${n}"; "$$" is '$'.
+ *
+ *       Matching uses (mutable) scratch memory allocated up front, i.e. it
+ *       does not allocate per input. Hence a Regex must not be shared
+ *       between threads; copy it instead.
+ */
+
+class Regex {
+public:
+  static constexpr std::size_t NPOS = std::wstring_view::npos;
+
+  // Offsets of group n: [2n, 2n + 1); NPOS if the group did not match.
+  using Captures = std::vector<std::size_t>;
+
+  Regex() noexcept;
+  Regex(const std::wstring_view& pattern,
+        const std::wstring_view& replace = std::wstring_view()) noexcept;
+  ~Regex() noexcept;
+
+  bool isValid() const;
+
+  std::size_t numGroups() const;
+
+  // Leftmost match at or after pos; cf. captures().
+  bool search(const std::wstring_view& input, const std::size_t pos = 0) const;
+
+  // Captures of the last successful search().
+  const Captures& captures() const;
+
+  // Appends input to result, with all matches substituted by the replacement.
+  bool replaceAll(std::wstring& result, const std::wstring_view& input) const;
+
+private:
+  enum class Op : uint8_t {
+    Char = 0,
+    Any,
+    Class,
+    Begin,
+    End,
+    Save,
+    Split,
+    Jump,
+    Match
+  };
+
+  struct Inst {
+    Op op{Op::Match};
+    uint32_t x{0};
+    uint32_t y{0};
+  };
+
+  struct Range {
+    wchar_t first{0};
+    wchar_t last{0};
+  };
+
+  struct CharClass {
+    std::vector<Range> ranges{};
+    bool isNegated{false};
+  };
+
+  // Replacement: Literal text, if group == NPOS; a group reference otherwise.
+  struct Piece {
+    std::size_t group{NPOS};
+    std::wstring text{};
+  };
+
+  // Sparse set of threads, in order of priority.
+  struct Threads {
+    void clear();
+    void resize(const std::size_t numInsts, const std::size_t numSlots);
+
+    std::vector<uint32_t> dense{};
+    std::vector<uint32_t> sparse{};
+    std::vector<std::size_t> slots{};
+    std::size_t size{0};
+  };
+
+  struct Frame {
+    uint32_t pc{0};
+    uint32_t slot{0};
+    std::size_t value{0};
+    bool isRestore{false};
+  };
+
+  class Parser;
+
+  void addThread(Threads& list, const uint32_t pc, const std::size_t pos,
+                 const std::wstring_view& input) const;
+  bool compileReplace(const std::wstring_view& replace);
+  bool isMatch(const Inst& inst, const wchar_t ch) const;
+
+  std::vector<Inst> _program{};
+  std::vector<CharClass> _classes{};
+  std::vector<Piece> _replace{};
+  std::size_t _numGroups{0};
+  bool _isCaseInsensitive{false};
+
+  mutable Captures _captures{};
+  mutable Captures _work{};
+  mutable std::vector<Frame> _stack{};
+  mutable Threads _current{};
+  mutable Threads _next{};
+};
@@ -31,16 +31,23 @@
 
 #pragma once
 
-#include <filesystem>
 #include <string>
 
+/*
+ * NOTE: A Rename holds the user's settings; cf. RenameEngine for applying
+ *       them to filenames. Regex's syntax is documented in Regex.h, Multi's
+ *       (i.e. many literal patterns at once) in MultiReplace.h.
+ */
+
 struct Rename {
   enum Mode : unsigned {
     Invalid = 0,
     Append,
     Prepend,
     Remove,
-    Replace
+    Replace,
+    Regex,
+    Multi
   };
 
   Rename(const Mode mode             = Invalid,
@@ -50,8 +57,6 @@ struct Rename {
 
   bool isValid() const;
 
-  void operator()(const std::filesystem::path& path) const;
-
   Mode mode{Invalid};
   std::wstring pattern;
   std::wstring replace;
@@ -31,15 +31,36 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <cs/System/FileSystem.h>
+
 #include "Rename.h"
+#include "RenamePreview.h"
 #include "Win32/UI/Dialog.h"
 
+/*
+ * NOTE: The preview is updated on a background thread, once the user stops
+ *       typing for a moment; a newer request cancels any pending update.
+ */
+
 class RenameDialog : public ui::Dialog {
 public:
-  RenameDialog() noexcept;
+  RenameDialog(const cs::PathList& files = cs::PathList()) noexcept;
   ~RenameDialog() noexcept;
 
+  bool exec(HINSTANCE_t instance, HWND_t parent = nullptr);
+
+  LRESULT_t onCancel(WPARAM_t wParam, LPARAM_t lParam);
+  LRESULT_t onCommand(WPARAM_t wParam, LPARAM_t lParam);
+  LRESULT_t onNotify(WPARAM_t wParam, LPARAM_t lParam);
   LRESULT_t onOk(WPARAM_t wParam, LPARAM_t lParam);
+  LRESULT_t onTimer(WPARAM_t wParam, LPARAM_t lParam);
+  LRESULT_t onUser(UINT_t msg, WPARAM_t wParam, LPARAM_t lParam);
 
 protected:
   LRESULT_t onInitDialog(HWND_t wnd, LPARAM_t lParam);
@@ -50,4 +71,23 @@ protected:
 
 public:
   Rename data;
+
+private:
+  Rename currentRename() const;
+  void previewLoop();
+  void requestPreview(const Rename& rename);
+  void stopPreview();
+  void updatePreview();
+
+  cs::PathList _files{};
+  RenamePreviewPtr _preview{};
+  RenamePreview::Row _row{}; // cf. LVN_GETDISPINFO
+
+  std::thread _worker{};
+  std::mutex _mutex{};
+  std::condition_variable _cond{};
+  std::optional<Rename> _request{};     // Guarded by _mutex
+  RenamePreview::Indices _changed{};    // Guarded by _mutex
+  std::atomic<unsigned> _generation{0}; // Incremented per request
+  std::atomic<bool> _stop{false};
 };
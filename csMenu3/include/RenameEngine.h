@@ -0,0 +1,72 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "MultiReplace.h"
+#include "Regex.h"
+#include "Rename.h"
+
+/*
+ * NOTE: A RenameEngine compiles a Rename once per job, e.g. its Regex,
+ *       and computes new filenames into a caller-provided buffer; i.e.
+ *       renaming a file does not allocate, once the buffer has grown.
+ *
+ *       An engine holds scratch memory and must not be shared between
+ *       threads; copy it instead.
+ */
+
+class RenameEngine {
+public:
+  RenameEngine(const Rename& rename) noexcept;
+  ~RenameEngine() noexcept;
+
+  bool isValid() const;
+
+  // New filename of path, w/o directory; false if empty or unchanged.
+  bool newName(std::wstring& result, const std::filesystem::path& path) const;
+
+  // Same as above, for a filename w/o directory.
+  bool newName(std::wstring& result, const std::wstring_view& filename) const;
+
+private:
+  RenameEngine() noexcept = delete;
+
+  void apply(std::wstring& result, const std::wstring_view& item) const;
+
+  Rename _rename{};
+  Regex _regex{};
+  MultiReplace _multi{};
+};
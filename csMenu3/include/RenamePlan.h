@@ -0,0 +1,125 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <cs/System/FileSystem.h>
+
+#include "RenameEngine.h"
+
+/*
+ * NOTE: A RenamePlan computes all targets up front & detects collisions
+ *       before anything is touched:
+ *
+ *       - Targets shared by several files are collisions.
+ *       - Targets occupied by an object staying in place already exist.
+ *       - Targets occupied by a file that is renamed itself depend on it;
+ *         chains of renames are ordered, cycles (e.g. swaps) are broken
+ *         by moving one file to a temporary name first.
+ *
+ *       As targets never leave their directory, directories are planned
+ *       independently and in parallel. The chains, i.e. the steps depending
+ *       on each other, are executed in parallel, too; even within the same
+ *       directory. Existing objects are never replaced; cf. fileop::rename().
+ */
+
+namespace fileop {
+  class Directory;
+} // namespace fileop
+
+class RenamePlan {
+public:
+  enum class Status : unsigned {
+    Unchanged = 0,
+    Pending,
+    Renamed,
+    Collision,
+    Exists,
+    Blocked, // Depends on a file that can not be renamed
+    Failed,
+    Stranded // Failed & left under a temporary name; cf. Item::current
+  };
+
+  struct Item {
+    std::filesystem::path source{};
+    std::wstring target{}; // Filename w/o directory
+    Status status{Status::Unchanged};
+    std::wstring current{}; // Filename w/o directory, if Stranded
+  };
+
+  using Items = std::vector<Item>;
+
+  RenamePlan() noexcept;
+  ~RenamePlan() noexcept;
+
+  bool plan(const cs::PathList& files, const RenameEngine& engine);
+
+  // Returns the number of renamed items.
+  std::size_t execute();
+
+  std::size_t count(const Status status) const;
+
+  const Items& items() const;
+
+  std::wstring report() const;
+
+private:
+  enum class StepKind : unsigned {
+    Direct = 0,
+    ToTemporary,
+    FromTemporary
+  };
+
+  // Filenames are relative to the group's directory.
+  struct Step {
+    std::size_t item{0};
+    std::wstring from{};
+    std::wstring to{};
+    StepKind kind{StepKind::Direct};
+  };
+
+  struct Group {
+    std::filesystem::path directory{};
+    std::vector<std::size_t> items{};
+    std::vector<Step> steps{};
+    std::vector<std::size_t> chains{}; // Index of each chain's first step
+  };
+
+  void executeChain(fileop::Directory& directory, const Group& group, const std::size_t chain);
+  void planGroup(Group& group);
+
+  Items _items{};
+  std::vector<Group> _groups{};
+};
@@ -0,0 +1,119 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/System/FileSystem.h>
+
+#include "Rename.h"
+
+/*
+ * NOTE: A RenamePreview computes a selection's new names for display, w/o
+ *       touching the file system; cf. RenamePlan for the real thing.
+ *       Updates are incremental:
+ *
+ *       - Only rows whose new name or state changed are reported.
+ *       - If a literal pattern was merely extended, e.g. while typing,
+ *         rows that did not contain the previous pattern are skipped.
+ *       - Every row occupies its new name, or its name if unchanged; rows
+ *         occupying the same name collide. Occupants are tracked per name,
+ *         i.e. only rows sharing a changed name are re-evaluated.
+ *
+ *       All members are thread-safe; update() is meant to be run on a
+ *       background thread and may be cancelled.
+ */
+
+using RenamePreviewPtr = std::shared_ptr<class RenamePreview>;
+
+class RenamePreview {
+private:
+  struct ctor_tag {
+    ctor_tag() noexcept;
+  };
+
+public:
+  using CancelFunc = std::function<bool()>;
+  using Indices    = std::vector<std::size_t>;
+
+  struct Row {
+    std::wstring name{};
+    std::wstring target{}; // Empty, if unchanged
+    bool isCollision{false};
+  };
+
+  RenamePreview(const ctor_tag&) noexcept;
+  ~RenamePreview() noexcept;
+
+  bool isCollision(const std::size_t index) const;
+
+  std::size_t numCollisions() const;
+
+  bool row(const std::size_t index, Row& result) const;
+
+  std::size_t size() const;
+
+  // Indices of changed rows are appended to changed; false if cancelled.
+  bool update(const Rename& rename, Indices& changed,
+              const CancelFunc& isCancelled = CancelFunc());
+
+  static RenamePreviewPtr make(const cs::PathList& files);
+
+private:
+  using Occupants = std::unordered_map<std::wstring, std::vector<uint32_t>>; // Key -> Rows
+  using Targets   = std::vector<std::pair<std::size_t, std::wstring>>;
+
+  bool isExtended(const Rename& rename) const;
+  std::wstring key(const std::size_t index) const;
+  void occupy(const std::size_t index, Indices& affected);
+  void setCollision(const std::size_t index, const bool on, Indices& affected);
+  void vacate(const std::size_t index, Indices& affected);
+
+  mutable std::mutex _mutex{}; // Guards rows
+  std::mutex _update{};        // Serializes updates
+  std::vector<std::wstring> _names{};
+  std::vector<uint32_t> _directories{};
+  std::vector<std::wstring> _targets{};
+  std::vector<bool> _isCandidate{};
+  std::vector<bool> _isCollision{};
+  std::vector<uint32_t> _positions{}; // Row's position in its occupants
+  Occupants _occupants{};
+  std::size_t _numCollisions{0};
+  Rename _rename{};
+};
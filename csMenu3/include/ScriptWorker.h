@@ -35,6 +35,8 @@
 
 void batch_work(WorkContext ctx);
 
+void parallel_batch_work(WorkContext ctx);
+
 void parallel_work(WorkContext ctx);
 
 void sequential_work(WorkContext ctx);
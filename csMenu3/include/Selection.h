@@ -0,0 +1,145 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/System/FileSystem.h>
+
+/*
+ * NOTE: A Selection stores all of its items' characters in one arena; items
+ *       refer to their interned parent directory and their name by offset.
+ *       As selections are almost always taken from one folder, the parent
+ *       is typically stored once.
+ *
+ *       Items are accessed as views, which remain valid until the Selection
+ *       is modified.
+ */
+
+class Selection {
+public:
+  struct Item {
+    std::size_t parentId{0};
+    std::wstring_view parent{}; // Keeps its separator only if it is a root, e.g. "C:\"
+    std::wstring_view name{};   // Empty, if the item is a root itself
+
+    std::wstring filename() const;
+    std::filesystem::path path() const;
+  };
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = Item;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = Item;
+
+    const_iterator(const Selection *selection = nullptr, const std::size_t index = 0) noexcept
+      : _selection{selection}
+      , _index{index}
+    {
+    }
+
+    inline Item operator*() const
+    {
+      return (*_selection)[_index];
+    }
+
+    inline const_iterator& operator++()
+    {
+      _index++;
+      return *this;
+    }
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator result = *this;
+      _index++;
+      return result;
+    }
+
+    inline bool operator==(const const_iterator& other) const
+    {
+      return _index == other._index;
+    }
+
+  private:
+    const Selection *_selection{nullptr};
+    std::size_t _index{0};
+  };
+
+  Selection() noexcept;
+  ~Selection() noexcept;
+
+  bool empty() const;
+  std::size_t size() const;
+  std::size_t numParents() const;
+  std::wstring_view parent(const std::size_t parentId) const;
+
+  Item operator[](const std::size_t index) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  void append(const std::wstring_view& filename);
+  void sort();
+
+  cs::PathList paths() const;
+
+private:
+  struct Span {
+    uint32_t offset{0};
+    uint32_t length{0};
+  };
+
+  struct Entry {
+    uint32_t parentId{0};
+    Span name{};
+  };
+
+  std::wstring_view view(const Span& span) const;
+  Span store(const std::wstring_view& str);
+  uint32_t intern(const std::wstring_view& parent);
+
+  std::wstring _arena{};
+  std::vector<Span> _parents{};
+  std::vector<Entry> _entries{};
+  std::unordered_map<std::wstring, uint32_t> _parentIds{};
+};
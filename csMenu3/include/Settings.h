@@ -32,7 +32,9 @@
 #pragma once
 
 #define KEY_CSMENU L"Software\\csLabs\\csMenu"
+#define KEY_VOLUMES KEY_CSMENU L"\\Volumes"
 
+#define NAME_BATCH_SIZE L"BatchSize"
 #define NAME_FLAGS L"Flags"
 #define NAME_PARALLEL_COUNT L"ParallelCount"
 #define NAME_SCRIPTS L"Scripts"
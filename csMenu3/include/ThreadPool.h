@@ -0,0 +1,342 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * NOTE: The ThreadPool is shared by all of the DLL's jobs; it limits their
+ *       combined concurrency to the number of cores:
+ *
+ *       - Workers are started lazily and exit after being idle for a while.
+ *       - Each worker owns a queue; it runs its own tasks newest first and
+ *         steals other's tasks oldest first; cf. DirectoryWalker.
+ *       - Jobs, i.e. invocations hosting GUI (e.g. progress bars) or waiting
+ *         for the network, run on threads of their own via launch(); they
+ *         are not part of the budget, but are tracked like workers.
+ *       - release() joins all threads, once no job or task is pending;
+ *         cf. DllCanUnloadNow().
+ *
+ *       A task must not wait for tasks queued after it, except via forEach(),
+ *       which runs on the calling thread, too.
+ */
+
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  static ThreadPool& instance();
+
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t budget() const;
+
+  // Runs job on a thread of its own.
+  bool launch(Task job);
+
+  // Queues task; false if there is no worker to run it, i.e. it is dropped.
+  bool submit(Task task);
+
+  // Joins all threads; false while any job or task is pending.
+  bool release();
+
+  // Calls func(i) for i in [0, count), on the calling thread & on up to
+  // maxThreads - 1 workers; returns once all calls have returned.
+  template <typename Func>
+  void forEach(const std::size_t count, const std::size_t maxThreads, Func&& func);
+
+  // Calls func(*it) for it in [first, last), on up to maxThreads workers.
+  template <typename Iter, typename Func>
+  std::future<void> forEachAsync(Iter first, Iter last, const std::size_t maxThreads, Func func);
+
+  // Reduces map(*it) for it in [first, last), in no particular order,
+  // into a T via reduce(T&, map(*it)) & reduce(T&, T&&); on up to
+  // maxThreads workers.
+  template <typename T, typename Iter, typename MapFunc, typename ReduceFunc>
+  std::future<T> mapReduceAsync(Iter first, Iter last, const std::size_t maxThreads,
+                                MapFunc map, ReduceFunc reduce);
+
+private:
+  // Shared by the tasks of forEachAsync() & mapReduceAsync().
+  template <typename Iter>
+  struct Range {
+    Range(Iter first, Iter last)
+      : next{first}
+      , last{last}
+    {
+    }
+
+    bool take(Iter& it)
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if( next == last ) {
+        return false;
+      }
+      it = next++;
+      return true;
+    }
+
+    // True for the last task to finish.
+    bool finish(const std::exception_ptr& taskError)
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if( taskError && !error ) {
+        error = taskError;
+      }
+      return --numTasks == 0;
+    }
+
+    std::mutex mutex{};
+    Iter next;
+    Iter last;
+    std::size_t numTasks{0};
+    std::exception_ptr error{};
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  struct Thread {
+    std::thread thread{};
+    bool isExited{false};
+  };
+
+  ThreadPool() noexcept;
+
+  Task pop(const std::size_t self);
+  void push(const std::size_t self, Task&& task);
+  void reapJobs();
+  void run(const std::size_t self);
+  bool startWorker();
+
+  template <typename Iter>
+  void startAsync(Range<Iter>& range, const std::size_t maxThreads, const Task& work);
+
+  std::size_t _budget{1};
+  std::vector<std::unique_ptr<Queue>> _queues{};
+  std::atomic<std::size_t> _numPending{0};
+  std::atomic<std::size_t> _next{0};
+
+  // Guarded by _mutex.
+  std::mutex _mutex;
+  std::condition_variable _work;
+  std::vector<Thread> _workers{};
+  std::list<Thread> _jobs{};
+  std::size_t _numIdle{0};
+  std::size_t _numRunning{0};
+  std::size_t _numWakeups{0};
+  bool _isStopping{false};
+};
+
+////// Implementation ////////////////////////////////////////////////////////
+
+template <typename Func>
+void ThreadPool::forEach(const std::size_t count, const std::size_t maxThreads, Func&& func)
+{
+  struct State {
+    std::atomic<std::size_t> next{0};
+    std::size_t numDone{0};
+    std::exception_ptr error{};
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  const std::size_t numThreads = std::min({maxThreads, count, _budget + 1});
+  if( numThreads < 2 ) {
+    for( std::size_t i = 0; i < count; i++ ) {
+      func(i);
+    }
+    return;
+  }
+
+  // NOTE: Tasks starting late find no work; hence, they never access func
+  //       after this function returned.
+  const std::shared_ptr<State> state = std::make_shared<State>();
+  std::remove_reference_t<Func> *f   = &func;
+
+  const auto lambda_work = [state, f, count]() -> void {
+    for( std::size_t i = state->next++; i < count; i = state->next++ ) {
+      std::exception_ptr error;
+      try {
+        (*f)(i);
+      } catch( ... ) {
+        error = std::current_exception();
+      }
+
+      const std::lock_guard<std::mutex> lock(state->mutex);
+      if( error && !state->error ) {
+        state->error = error;
+      }
+      if( ++state->numDone == count ) {
+        state->done.notify_all();
+      }
+    }
+  };
+
+  for( std::size_t i = 1; i < numThreads; i++ ) {
+    submit(lambda_work);
+  }
+  lambda_work();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done.wait(lock, [&]() -> bool {
+    return state->numDone == count;
+  });
+
+  if( state->error ) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+template <typename Iter, typename Func>
+std::future<void> ThreadPool::forEachAsync(Iter first, Iter last, const std::size_t maxThreads, Func func)
+{
+  struct State : Range<Iter> {
+    State(Iter first, Iter last, Func&& func)
+      : Range<Iter>(first, last)
+      , func(std::move(func))
+    {
+    }
+
+    Func func;
+    std::promise<void> promise{};
+  };
+
+  const std::shared_ptr<State> state = std::make_shared<State>(first, last, std::move(func));
+  std::future<void> result           = state->promise.get_future();
+
+  const auto lambda_work = [state]() -> void {
+    std::exception_ptr error;
+    for( Iter it; state->take(it); ) {
+      try {
+        state->func(*it);
+      } catch( ... ) {
+        error = std::current_exception();
+      }
+    }
+
+    if( state->finish(error) ) {
+      if( state->error ) {
+        state->promise.set_exception(state->error);
+      } else {
+        state->promise.set_value();
+      }
+    }
+  };
+
+  startAsync(*state, maxThreads, lambda_work);
+
+  return result;
+}
+
+template <typename T, typename Iter, typename MapFunc, typename ReduceFunc>
+std::future<T> ThreadPool::mapReduceAsync(Iter first, Iter last, const std::size_t maxThreads,
+                                          MapFunc map, ReduceFunc reduce)
+{
+  struct State : Range<Iter> {
+    State(Iter first, Iter last, MapFunc&& map, ReduceFunc&& reduce)
+      : Range<Iter>(first, last)
+      , map(std::move(map))
+      , reduce(std::move(reduce))
+    {
+    }
+
+    MapFunc map;
+    ReduceFunc reduce;
+    T result{};
+    std::promise<T> promise{};
+  };
+
+  const std::shared_ptr<State> state = std::make_shared<State>(first, last, std::move(map), std::move(reduce));
+  std::future<T> result              = state->promise.get_future();
+
+  const auto lambda_work = [state]() -> void {
+    std::exception_ptr error;
+    T local{};
+    for( Iter it; state->take(it); ) {
+      try {
+        state->reduce(local, state->map(*it));
+      } catch( ... ) {
+        error = std::current_exception();
+      }
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(state->mutex);
+      state->reduce(state->result, std::move(local));
+    }
+
+    if( state->finish(error) ) {
+      if( state->error ) {
+        state->promise.set_exception(state->error);
+      } else {
+        state->promise.set_value(std::move(state->result));
+      }
+    }
+  };
+
+  startAsync(*state, maxThreads, lambda_work);
+
+  return result;
+}
+
+template <typename Iter>
+void ThreadPool::startAsync(Range<Iter>& range, const std::size_t maxThreads, const Task& work)
+{
+  const std::size_t count    = static_cast<std::size_t>(std::distance(range.next, range.last));
+  const std::size_t numTasks = std::max<std::size_t>(1, std::min({maxThreads, count, _budget}));
+
+  range.numTasks = numTasks;
+  for( std::size_t i = 0; i < numTasks; i++ ) {
+    if( !submit(work) ) {
+      work(); // Drains the range on the calling thread
+    }
+  }
+}
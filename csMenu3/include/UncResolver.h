@@ -0,0 +1,77 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/System/FileSystem.h>
+
+#include "Selection.h"
+
+/*
+ * NOTE: Mapped drives are resolved once per drive letter, rather than once
+ *       per file. All of the selection's drives are looked up concurrently;
+ *       a drive not answering within the timeout (e.g. a dead share) keeps
+ *       its local paths.
+ *
+ *       Lookups are cached process-wide for CACHE_LIFETIME. A lookup still
+ *       pending is shared by subsequent invocations, and its late result is
+ *       cached, too.
+ */
+
+class UncResolver {
+public:
+  static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{2000};
+  static constexpr std::chrono::seconds CACHE_LIFETIME{60};
+
+  UncResolver(const cs::PathList& selection,
+              const std::chrono::milliseconds timeout = DEFAULT_TIMEOUT) noexcept;
+  UncResolver(const Selection& selection,
+              const std::chrono::milliseconds timeout = DEFAULT_TIMEOUT) noexcept;
+  ~UncResolver() noexcept;
+
+  // Returns the universal name, if any; the local name otherwise.
+  std::wstring resolve(std::wstring filename) const;
+
+  static void invalidate();
+
+private:
+  using Drives = std::vector<wchar_t>;
+
+  void lookup(const Drives& drives, const std::chrono::milliseconds timeout);
+
+  std::unordered_map<wchar_t, std::wstring> _roots{}; // Drive -> Universal Root
+};
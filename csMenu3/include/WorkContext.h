@@ -31,8 +31,26 @@
 
 #pragma once
 
+#include <vector>
+
 #include <cs/System/FileSystem.h>
 
+#include "FileSnapshot.h"
+
+// A file & its index in WorkContext::files.
+struct WorkFile {
+  std::filesystem::path filename{};
+  std::size_t index{0};
+};
+
+// Files of one volume & the number of threads reading them.
+struct WorkVolume {
+  std::vector<WorkFile> files{};
+  std::size_t numThreads{0};
+};
+
+using WorkVolumes = std::vector<WorkVolume>;
+
 struct WorkContext {
   WorkContext() noexcept;
 
@@ -41,7 +59,18 @@ struct WorkContext {
   bool setScript(const std::wstring& filename);
   bool setFiles(const cs::PathList& input);
 
+  // Group the files in [first, last) by volume; each volume's calibrated
+  // settings apply, if any (cf. TuneWorker), numThreads otherwise.
+  // NOTE: first & last must be iterators into files.
+  WorkVolumes volumes(cs::ConstPathListIter first, cs::ConstPathListIter last) const;
+
+  // Attributes are taken from the snapshot, if any.
+  bool isFile(const std::filesystem::path& filename) const;
+  uint64_t size(const std::filesystem::path& filename) const;
+
   cs::PathList files{};
   std::size_t numThreads{0};
+  std::size_t batchSize{0}; // Files per batch; 0 == Unlimited
   std::filesystem::path script{};
+  FileSnapshotPtr snapshot{}; // Optional; cf. isFile() & size()
 };
@@ -0,0 +1,96 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * NOTE: XXH3 is NOT a cryptographic hash!
+ *
+ * This is the 64 and 128 bit variant of xxHash's XXH3 (format of xxHash
+ * v0.8, default secret, seed 0), cf. https://github.com/Cyan4973/xxHash.
+ * The digests are identical to those of xxhsum's -H3 and -H2 options.
+ *
+ * The inner loop is provided by one of several kernels (Scalar, SSE2, AVX2,
+ * NEON); Kernel::Auto selects the fastest one supported by the CPU, once.
+ */
+
+struct XXH3_128 {
+  uint64_t low{0};
+  uint64_t high{0};
+};
+
+class XXH3 {
+public:
+  enum class Kernel : unsigned {
+    Auto = 0,
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+  };
+
+  XXH3(const Kernel kernel = Kernel::Auto) noexcept;
+  ~XXH3() noexcept;
+
+  void reset();
+
+  void update(const void *data, const std::size_t size);
+
+  uint64_t digest64() const;
+  XXH3_128 digest128() const;
+
+  Kernel kernel() const;
+
+  static bool isSupported(const Kernel kernel);
+  static const char *name(const Kernel kernel);
+
+  static constexpr std::size_t BUFFER_SIZE = 256;
+  static constexpr std::size_t NUM_ACC     = 8;
+
+  struct Functions; // Kernel's implementation
+
+private:
+  void digestLong(uint64_t *acc) const;
+
+  const Functions *_funcs{nullptr};
+  alignas(64) uint64_t _acc[NUM_ACC];
+  alignas(64) unsigned char _buffer[BUFFER_SIZE];
+  std::size_t _numBuffered{0};
+  std::size_t _numStripesAcc{0};
+  uint64_t _totalSize{0};
+};
+
+uint64_t xxh3_64(const void *data, const std::size_t size);
+
+XXH3_128 xxh3_128(const void *data, const std::size_t size);
@@ -41,6 +41,8 @@
 #define ID_EditPattern    2005
 #define ID_LabelReplace   2006
 #define ID_EditReplace    2007
+#define ID_ListPreview    2008
+#define ID_LabelStatus    2009
 
 #define WNDCLASS_RenameDialog L"RenameDialogUI"
 
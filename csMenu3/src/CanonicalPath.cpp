@@ -0,0 +1,120 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <optional>
+#include <vector>
+
+#include "CanonicalPath.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_canonical {
+
+  namespace fs = std::filesystem;
+
+  class Resolver {
+  public:
+    Resolver(const Selection& selection, const FileSnapshotPtr& snapshot)
+      : _selection{selection}
+      , _snapshot{snapshot}
+      , _parents(selection.numParents())
+    {
+    }
+
+    fs::path operator()(const Selection::Item& item)
+    {
+      const std::wstring filename = item.filename();
+      if( item.name.empty() || isReparsePoint(filename) ) {
+        return resolve(filename);
+      }
+
+      const std::wstring& parent = resolveParent(item.parentId);
+      if( parent.empty() ) {
+        return fs::path{filename};
+      }
+
+      return fs::path{parent} / item.name;
+    }
+
+  private:
+    // NOTE: A link's own parent does not lead to its target; cf. fileinfo::query().
+    bool isReparsePoint(const std::wstring& filename) const
+    {
+      const fileinfo::Info info = _snapshot
+                                  ? _snapshot->info(filename)
+                                  : fileinfo::query(filename.data());
+      return (info.attributes & fileinfo::ReparsePoint) != 0;
+    }
+
+    const std::wstring& resolveParent(const std::size_t parentId)
+    {
+      std::optional<std::wstring>& parent = _parents[parentId];
+      if( !parent ) {
+        const std::wstring dirname{_selection.parent(parentId)};
+        parent = fileinfo::finalPath(dirname.data());
+      }
+
+      return *parent;
+    }
+
+    static fs::path resolve(const std::wstring& filename)
+    {
+      const std::wstring result = fileinfo::finalPath(filename.data());
+      return !result.empty()
+             ? fs::path{result}
+             : fs::path{filename};
+    }
+
+    const Selection& _selection;
+    FileSnapshotPtr _snapshot{};
+    std::vector<std::optional<std::wstring>> _parents{}; // Parent ID -> Canonical Parent
+  };
+
+} // namespace impl_canonical
+
+////// Public ////////////////////////////////////////////////////////////////
+
+cs::PathList canonicalPaths(const Selection& selection, const FileSnapshotPtr& snapshot)
+{
+  cs::PathList result;
+
+  try {
+    impl_canonical::Resolver resolver(selection, snapshot);
+
+    for( const Selection::Item& item : selection ) {
+      result.push_back(resolver(item));
+    }
+  } catch( ... ) {
+    result.clear();
+  }
+
+  return result;
+}
@@ -37,18 +37,18 @@
 
 namespace impl_cmdinvoke {
 
-  cs::PathList makeFileList(IShellItemArray *items)
+  Selection makeSelection(IShellItemArray *items)
   {
     if( items == nullptr ) {
-      return cs::PathList{};
+      return Selection{};
     }
 
     DWORD count = 0;
     if( FAILED(items->GetCount(&count)) ) {
-      return cs::PathList{};
+      return Selection{};
     }
 
-    cs::PathList list;
+    Selection selection;
 
     wchar_t *displayName = nullptr;
     try {
@@ -63,19 +63,19 @@ namespace impl_cmdinvoke {
           continue;
         }
 
-        list.push_back(displayName);
+        selection.append(displayName);
         ::CoTaskMemFree(displayName);
         displayName = nullptr;
       } // For Each Item
 
-      list.sort();
+      selection.sort();
     } catch( ... ) {
       ::CoTaskMemFree(displayName);
       displayName = nullptr;
-      return cs::PathList{};
+      return Selection{};
     }
 
-    return list;
+    return selection;
   }
 
 } // namespace impl_cmdinvoke
@@ -95,7 +95,7 @@ IFACEMETHODIMP_(HRESULT) CommandInvoke::Invoke(IShellItemArray *psiItemArray, IB
 {
   UNREFERENCED_PARAMETER(pbc);
 
-  const cs::PathList selection = impl_cmdinvoke::makeFileList(psiItemArray);
+  const Selection selection = impl_cmdinvoke::makeSelection(psiItemArray);
 
   invokeCommandId(_id, _title, selection);
 
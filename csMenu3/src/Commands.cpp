@@ -45,6 +45,16 @@ std::wstring titleFromId(const CommandId id)
     return std::wstring{L"List (path)"};
   } else if( id == Command::ListPathTabular ) {
     return std::wstring{L"List (path, tabular)"};
+  } else if( id == Command::ListCanonical ) {
+    return std::wstring{L"List (canonical)"};
+  } else if( id == Command::ListDetailedCsv ) {
+    return std::wstring{L"List (detailed, CSV)"};
+  } else if( id == Command::ListDetailedTsv ) {
+    return std::wstring{L"List (detailed, TSV)"};
+  } else if( id == Command::ListDetailedJson ) {
+    return std::wstring{L"List (detailed, JSON)"};
+  } else if( id == Command::ListTree ) {
+    return std::wstring{L"List (tree)"};
   } else if( id == Command::Rename ) {
     return std::wstring(L"Rename...");
   } else if( id == Command::CheckBatchProcessing ) {
@@ -55,6 +65,10 @@ std::wstring titleFromId(const CommandId id)
     return std::wstring{L"Resolve UNC paths"};
   } else if( id == Command::CheckUnixPathSeparators ) {
     return std::wstring{L"UN*X path separators"};
+  } else if( id == Command::CheckHashSidecarFiles ) {
+    return std::wstring{L"Hash sidecar files"};
+  } else if( id == Command::CalibrateStorage ) {
+    return std::wstring{L"Calibrate storage"};
   } else if( id == Command::HashMenu ) {
     return std::wstring(L"CS::Sum");
   } else if( id == Command::HashCrc32 ) {
@@ -71,6 +85,12 @@ std::wstring titleFromId(const CommandId id)
     return std::wstring(L"SHA-384");
   } else if( id == Command::HashSha512 ) {
     return std::wstring(L"SHA-512");
+  } else if( id == Command::HashXxh3_64 ) {
+    return std::wstring(L"XXH3-64 (non-cryptographic)");
+  } else if( id == Command::HashXxh3_128 ) {
+    return std::wstring(L"XXH3-128 (non-cryptographic)");
+  } else if( id == Command::HashFingerprint ) {
+    return std::wstring(L"Fingerprint (non-cryptographic)");
   } else if( id == Command::ScriptMenu ) {
     return std::wstring{L"CS::Run"};
   }
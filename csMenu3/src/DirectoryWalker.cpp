@@ -0,0 +1,369 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include "DirectoryWalker.h"
+
+#include "SortKey.h"
+#include "ThreadPool.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_walker {
+
+  constexpr wchar_t SEP = std::filesystem::path::preferred_separator;
+
+  struct Node;
+
+  using NodePtr = std::unique_ptr<Node>;
+
+  struct Entry {
+    std::wstring name{};
+    fileinfo::Info info{};
+    NodePtr child{}; // Directories only
+  };
+
+  struct Node {
+    Node(std::wstring path, const bool is_root) noexcept
+      : path{std::move(path)}
+      , is_root{is_root}
+    {
+    }
+
+    std::wstring path{};
+    bool is_root{false};
+
+    // Guarded by Walk::mutex until is_listed; read-only afterwards.
+    fileinfo::Info info{}; // Roots only
+    std::vector<Entry> entries{};
+    bool is_listed{false};
+    bool is_ok{true};
+  };
+
+  struct WorkQueue {
+    std::mutex mutex{};
+    std::deque<Node *> nodes{};
+  };
+
+  struct Walk {
+    Walk(const std::size_t numThreads)
+      : queues(numThreads)
+    {
+    }
+
+    std::vector<WorkQueue> queues;
+    std::atomic<std::size_t> numPending{0}; // Queued or being listed
+    std::atomic<std::size_t> numQueued{0};  // Queued only
+    std::atomic<bool> is_cancelled{false};
+
+    // Workers -> Caller
+    std::mutex mutex{};
+    std::condition_variable listed{};
+
+    // Idle Workers; signalled on new work or when the walk is done
+    std::mutex idleMutex{};
+    std::condition_variable work{};
+  };
+
+  void signal(Walk& walk, const bool is_done)
+  {
+    // NOTE: Taking the lock orders the signal after an idle worker's check.
+    {
+      const std::lock_guard<std::mutex> lock(walk.idleMutex);
+    }
+
+    if( is_done ) {
+      walk.work.notify_all();
+    } else {
+      walk.work.notify_one();
+    }
+  }
+
+  inline std::wstring join(const std::wstring& path, const std::wstring& name)
+  {
+    return !path.empty() && path.back() == SEP
+           ? path + name
+           : path + SEP + name;
+  }
+
+  // Natural order; cf. SortKey.h
+  void sortEntries(std::vector<Entry>& entries)
+  {
+    std::vector<std::wstring> keys;
+    keys.reserve(entries.size());
+    for( const Entry& entry : entries ) {
+      keys.push_back(makeSortKey(entry.name));
+    }
+
+    std::vector<std::size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](const std::size_t a, const std::size_t b) -> bool {
+                const int cmp = keys[a].compare(keys[b]);
+                return cmp != 0
+                       ? cmp < 0
+                       : entries[a].name < entries[b].name;
+              });
+
+    std::vector<Entry> sorted;
+    sorted.reserve(entries.size());
+    for( const std::size_t i : order ) {
+      sorted.push_back(std::move(entries[i]));
+    }
+    entries = std::move(sorted);
+  }
+
+  void push(Walk& walk, const std::size_t self, Node *node)
+  {
+    walk.numPending++;
+    {
+      const std::lock_guard<std::mutex> lock(walk.queues[self].mutex);
+      walk.queues[self].nodes.push_back(node);
+    }
+    walk.numQueued++;
+    signal(walk, false);
+  }
+
+  Node *pop(Walk& walk, const std::size_t self)
+  {
+    // (1) Own Work; Newest First ////////////////////////////////////////////
+
+    {
+      WorkQueue& own = walk.queues[self];
+
+      const std::lock_guard<std::mutex> lock(own.mutex);
+      if( !own.nodes.empty() ) {
+        Node *node = own.nodes.back();
+        own.nodes.pop_back();
+        walk.numQueued--;
+        return node;
+      }
+    }
+
+    // (2) Steal Other's Work; Oldest First //////////////////////////////////
+
+    const std::size_t numQueues = walk.queues.size();
+    for( std::size_t i = 1; i < numQueues; i++ ) {
+      WorkQueue& victim = walk.queues[(self + i) % numQueues];
+
+      const std::lock_guard<std::mutex> lock(victim.mutex);
+      if( !victim.nodes.empty() ) {
+        Node *node = victim.nodes.front();
+        victim.nodes.pop_front();
+        walk.numQueued--;
+        return node;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void listNode(Walk& walk, const std::size_t self, Node *node)
+  {
+    fileinfo::Info info;
+    std::vector<Entry> entries;
+    std::vector<Node *> children;
+    bool is_ok = true;
+
+    try {
+      // (1) Roots may be Files //////////////////////////////////////////////
+
+      const bool is_dir = node->is_root
+                          ? (info = fileinfo::query(node->path.data())).type == fileinfo::Type::Directory
+                          : true;
+
+      // (2) Read Directory //////////////////////////////////////////////////
+
+      if( is_dir && !walk.is_cancelled ) {
+        is_ok = fileinfo::list(node->path.data(), [&](const std::wstring_view& name, const fileinfo::Info& data) -> void {
+          entries.push_back(Entry{std::wstring{name}, data, NodePtr{}});
+        });
+
+        sortEntries(entries);
+
+        for( Entry& entry : entries ) {
+          // NOTE: Reparse points (e.g. junctions) are listed, but not descended into.
+          if( entry.info.type == fileinfo::Type::Directory &&
+              (entry.info.attributes & fileinfo::ReparsePoint) == 0 ) {
+            entry.child = std::make_unique<Node>(join(node->path, entry.name), false);
+            children.push_back(entry.child.get());
+          }
+        }
+      }
+    } catch( ... ) {
+      entries.clear();
+      children.clear();
+      is_ok = false;
+    }
+
+    // (3) Publish ///////////////////////////////////////////////////////////
+
+    {
+      const std::lock_guard<std::mutex> lock(walk.mutex);
+      node->info      = info;
+      node->entries   = std::move(entries);
+      node->is_listed = true;
+      node->is_ok     = is_ok;
+    }
+    walk.listed.notify_all();
+
+    // NOTE: The node must not be accessed anymore; cf. emit().
+
+    // (4) Queue Subdirectories; First Child on Top //////////////////////////
+
+    for( auto it = children.rbegin(); it != children.rend(); ++it ) {
+      push(walk, self, *it);
+    }
+
+    if( --walk.numPending == 0 ) {
+      signal(walk, true);
+    }
+  }
+
+  void worker(Walk *walk, const std::size_t self)
+  {
+    while( true ) {
+      Node *node = pop(*walk, self);
+      if( node != nullptr ) {
+        listNode(*walk, self, node);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(walk->idleMutex);
+      walk->work.wait(lock, [walk]() -> bool {
+        return walk->numQueued > 0 || walk->numPending == 0;
+      });
+      if( walk->numPending == 0 ) {
+        break;
+      }
+    }
+  }
+
+  void emit(Walk& walk, Node *node, const std::wstring& path, const WalkFunc& func, bool& is_ok)
+  {
+    {
+      std::unique_lock<std::mutex> lock(walk.mutex);
+      walk.listed.wait(lock, [node]() -> bool {
+        return node->is_listed;
+      });
+    }
+    is_ok = is_ok && node->is_ok;
+
+    if( node->is_root ) {
+      func(WalkEntry{path, node->info});
+    }
+
+    for( Entry& entry : node->entries ) {
+      const std::wstring filename = join(path, entry.name);
+
+      func(WalkEntry{filename, entry.info});
+
+      if( entry.child ) {
+        emit(walk, entry.child.get(), filename, func, is_ok);
+        entry.child.reset(); // Done!
+      }
+    }
+  }
+
+} // namespace impl_walker
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool walkDirectories(const cs::PathList& roots, const std::size_t numThreads, const WalkFunc& func)
+{
+  using namespace impl_walker;
+
+  if( roots.empty() || !func ) {
+    return false;
+  }
+
+  const std::size_t numWorkers = std::max<std::size_t>(1, numThreads);
+
+  std::unique_ptr<Walk> walk;
+  std::vector<NodePtr> nodes;
+  try {
+    walk = std::make_unique<Walk>(numWorkers);
+
+    for( const std::filesystem::path& root : roots ) {
+      nodes.push_back(std::make_unique<Node>(root.wstring(), true));
+    }
+  } catch( ... ) {
+    return false;
+  }
+
+  // (1) Distribute Roots ////////////////////////////////////////////////////
+
+  for( std::size_t i = 0; i < nodes.size(); i++ ) {
+    push(*walk, i % numWorkers, nodes[i].get());
+  }
+
+  // (2) Start Workers; cf. ThreadPool ///////////////////////////////////////
+
+  std::vector<std::size_t> ids;
+  std::future<void> workers;
+  try {
+    ids.resize(numWorkers);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    workers = ThreadPool::instance().forEachAsync(ids.begin(), ids.end(), numWorkers,
+                                                  [w = walk.get()](const std::size_t self) -> void {
+                                                    worker(w, self);
+                                                  });
+  } catch( ... ) {
+    return false;
+  }
+  // NOTE: Workers started late find no work; the others steal their roots...
+
+  // (3) Emit Entries in Order ///////////////////////////////////////////////
+
+  bool is_ok = true;
+  try {
+    for( NodePtr& node : nodes ) {
+      emit(*walk, node.get(), node->path, func, is_ok);
+      node.reset();
+    }
+  } catch( ... ) {
+    walk->is_cancelled = true;
+    is_ok              = false;
+  }
+
+  workers.wait();
+
+  return is_ok;
+}
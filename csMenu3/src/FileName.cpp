@@ -33,20 +33,120 @@
 
 #include "FileName.h"
 
-std::wstring joinFileNames(const cs::PathList& files)
+#include "Win32/String.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_filename {
+
+  bool isQuoted(const NativeString& filename)
+  {
+    return cs::contains(filename, cs::lambda_is_space<NativeChar>());
+  }
+
+  std::size_t quotedSize(const NativeString& filename)
+  {
+    return isQuoted(filename)
+           ? filename.size() + 2
+           : filename.size();
+  }
+
+} // namespace impl_filename
+
+////// Public ////////////////////////////////////////////////////////////////
+
+void appendFileName(NativeString& result, const std::filesystem::path& filename)
+{
+  const NativeString& native = filename.native();
+
+  if( !impl_filename::isQuoted(native) ) {
+    result += native;
+    return;
+  }
+
+  result += NativeChar('"');
+  result += native;
+  result += NativeChar('"');
+}
+
+std::wstring foldFileName(const std::wstring_view& filename)
+{
+  std::wstring result(filename);
+
+  bool is_ascii = true;
+  for( wchar_t& ch : result ) {
+    if( ch >= L'a' && ch <= L'z' ) {
+      ch = ch - L'a' + L'A';
+    } else if( ch >= 0x80 ) {
+      is_ascii = false;
+    }
+  }
+
+  // NOTE: The C runtime's "C" locale maps ASCII only; e.g. "ä" -> "Ä" needs the OS.
+  if( !is_ascii ) {
+    StringToUpper(result.data(), filename.data(), filename.size());
+  }
+
+  return result;
+}
+
+NativeStrings batchFileNames(const cs::PathList& files,
+                             const std::size_t maxLength, const std::size_t maxFiles)
+{
+  NativeStrings result;
+  try {
+    NativeString batch;
+    std::size_t numFiles = 0;
+    for( const std::filesystem::path& file : files ) {
+      const std::size_t size = impl_filename::quotedSize(file.native());
+
+      const bool is_full = numFiles > 0 &&
+                           (batch.size() + 1 + size > maxLength ||
+                            (maxFiles > 0 && numFiles >= maxFiles));
+      if( is_full ) {
+        result.push_back(std::move(batch));
+        batch.clear();
+        numFiles = 0;
+      }
+
+      if( numFiles > 0 ) {
+        batch += NativeChar(' ');
+      }
+      appendFileName(batch, file);
+      numFiles++;
+    }
+
+    if( numFiles > 0 ) {
+      result.push_back(std::move(batch));
+    }
+  } catch( ... ) {
+    result.clear();
+  }
+
+  return result;
+}
+
+NativeString joinFileNames(const cs::PathList& files)
 {
   if( files.empty() ) {
-    return std::wstring{};
+    return NativeString{};
   }
 
-  std::wstring result;
+  NativeString result;
   try {
+    // Size the result once; large selections would otherwise reallocate often.
+    std::size_t size = files.size() - 1;
+    for( const std::filesystem::path& file : files ) {
+      size += impl_filename::quotedSize(file.native());
+    }
+    result.reserve(size);
+
     cs::ConstPathListIter iter = files.begin();
-    result += quotedFileName(*iter);
+    appendFileName(result, *iter);
 
     for( ++iter; iter != files.end(); ++iter ) {
-      result += L" ";
-      result += quotedFileName(*iter);
+      result += NativeChar(' ');
+      appendFileName(result, *iter);
     }
   } catch( ... ) {
     result.clear();
@@ -55,17 +155,12 @@ std::wstring joinFileNames(const cs::PathList& files)
   return result;
 }
 
-std::wstring quotedFileName(const std::wstring& filename)
+NativeString quotedFileName(const std::filesystem::path& filename)
 {
-  if( !cs::contains(filename, cs::lambda_is_space<wchar_t>()) ) {
-    return filename;
-  }
-
-  std::wstring result;
+  NativeString result;
   try {
-    result += L'"';
-    result += filename;
-    result += L'"';
+    result.reserve(impl_filename::quotedSize(filename.native()));
+    appendFileName(result, filename);
   } catch( ... ) {
     result.clear();
   }
@@ -0,0 +1,215 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include "FileSnapshot.h"
+
+#include "ThreadPool.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_snapshot {
+
+  // List a directory, if at least this many of its entries are selected...
+  constexpr std::size_t LIST_MIN_SELECTED = 8;
+
+  constexpr std::size_t MAX_QUERY_THREADS = 8;
+
+  using Names = std::unordered_map<std::wstring_view, std::wstring>; // Name -> Filename
+
+  using Filenames = std::vector<std::wstring>;
+  using InfoList  = std::vector<fileinfo::Info>;
+
+  InfoList queryParallel(const Filenames& filenames)
+  {
+    InfoList result(filenames.size());
+
+    ThreadPool::instance().forEach(filenames.size(), MAX_QUERY_THREADS, [&](const std::size_t i) -> void {
+      result[i] = fileinfo::query(filenames[i].data());
+    });
+
+    return result;
+  }
+
+} // namespace impl_snapshot
+
+////// public ////////////////////////////////////////////////////////////////
+
+FileSnapshot::FileSnapshot(const ctor_tag&) noexcept
+{
+}
+
+FileSnapshot::~FileSnapshot() noexcept
+{
+}
+
+fileinfo::Info FileSnapshot::info(const std::filesystem::path& filename) const
+{
+  try {
+    return info(filename.wstring());
+  } catch( ... ) {
+  }
+
+  return fileinfo::Info{};
+}
+
+fileinfo::Info FileSnapshot::info(const std::wstring& filename) const
+{
+  try {
+    {
+      const std::lock_guard<std::mutex> lock(_mutex);
+
+      const Infos::const_iterator hit = _infos.find(filename);
+      if( hit != _infos.cend() ) {
+        return hit->second;
+      }
+    }
+
+    const fileinfo::Info result = fileinfo::query(filename.data());
+
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _infos.emplace(filename, result);
+
+    return result;
+  } catch( ... ) {
+  }
+
+  return fileinfo::Info{};
+}
+
+bool FileSnapshot::isDirectory(const std::filesystem::path& filename) const
+{
+  return info(filename).type == fileinfo::Type::Directory;
+}
+
+bool FileSnapshot::isFile(const std::filesystem::path& filename) const
+{
+  return info(filename).type == fileinfo::Type::File;
+}
+
+uint64_t FileSnapshot::size(const std::filesystem::path& filename) const
+{
+  return info(filename).size;
+}
+
+cs::PathList FileSnapshot::files(const cs::PathList& input) const
+{
+  cs::PathList result;
+
+  try {
+    for( const std::filesystem::path& filename : input ) {
+      if( isFile(filename) ) {
+        result.push_back(filename);
+      }
+    }
+  } catch( ... ) {
+    result.clear();
+  }
+
+  return result;
+}
+
+FileSnapshotPtr FileSnapshot::make(const Selection& selection)
+{
+  std::shared_ptr<FileSnapshot> result;
+
+  try {
+    result = std::make_shared<FileSnapshot>(ctor_tag());
+  } catch( ... ) {
+    return FileSnapshotPtr{};
+  }
+
+  try {
+    result->capture(selection);
+  } catch( ... ) { // Whatever is missing will be queried on demand...
+  }
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+FileSnapshot::ctor_tag::ctor_tag() noexcept
+{
+}
+
+void FileSnapshot::capture(const Selection& selection)
+{
+  using namespace impl_snapshot;
+
+  // (1) Group Selection by Parent Directory /////////////////////////////////
+
+  std::vector<Names> dirs(selection.numParents());
+  Filenames singles;
+
+  for( const Selection::Item& item : selection ) {
+    if( item.name.empty() ) {
+      singles.push_back(item.filename());
+      continue;
+    }
+
+    dirs[item.parentId].emplace(item.name, item.filename());
+  }
+
+  // (2) List Directories with many Selected Entries /////////////////////////
+
+  for( std::size_t parentId = 0; parentId < dirs.size(); parentId++ ) {
+    Names& names = dirs[parentId];
+
+    if( names.size() >= LIST_MIN_SELECTED ) {
+      const std::wstring dirname{selection.parent(parentId)};
+
+      fileinfo::list(dirname.data(), [&](const std::wstring_view& name, const fileinfo::Info& info) -> void {
+        // NOTE: Listed links describe themselves; query() resolves them like any single.
+        const Names::iterator hit = names.find(name);
+        if( hit != names.end() && (info.attributes & fileinfo::ReparsePoint) == 0 ) {
+          _infos[hit->second] = info;
+          hit->second.clear(); // Done!
+        }
+      });
+    }
+
+    for( auto& [name, filename] : names ) {
+      if( !filename.empty() ) {
+        singles.push_back(std::move(filename));
+      }
+    }
+  } // For Each Directory
+
+  // (3) Query Remaining Entries in Parallel /////////////////////////////////
+
+  const InfoList infos = queryParallel(singles);
+  for( std::size_t i = 0; i < singles.size(); i++ ) {
+    _infos[singles[i]] = infos[i];
+  }
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "Fingerprint.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_fingerprint {
+
+  using Buffer = std::vector<char>;
+
+  constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+  constexpr std::size_t NUM_INNER  = 8; // Interior samples between head & tail
+
+  constexpr uint64_t BLOCK_ALIGN = 4096;
+
+  // FNV-1a, cf. http://www.isthe.com/chongo/tech/comp/fnv/index.html
+
+  constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325;
+  constexpr uint64_t FNV_PRIME  = 0x100000001b3;
+
+  uint64_t update(uint64_t hash, const void *data, const std::size_t size)
+  {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    for( std::size_t i = 0; i < size; i++ ) {
+      hash ^= bytes[i];
+      hash *= FNV_PRIME;
+    }
+    return hash;
+  }
+
+  uint64_t update(const uint64_t hash, const uint64_t value)
+  {
+    unsigned char bytes[sizeof(value)];
+    for( std::size_t i = 0; i < sizeof(value); i++ ) { // Little-endian
+      bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    return update(hash, bytes, sizeof(bytes));
+  }
+
+  std::vector<uint64_t> sampleOffsets(const uint64_t size)
+  {
+    std::vector<uint64_t> offsets;
+
+    if( size <= (NUM_INNER + 2) * BLOCK_SIZE ) { // Small enough to read everything
+      for( uint64_t offset = 0; offset < size; offset += BLOCK_SIZE ) {
+        offsets.push_back(offset);
+      }
+      return offsets;
+    }
+
+    const uint64_t last = size - BLOCK_SIZE;
+
+    offsets.push_back(0);
+    for( std::size_t i = 1; i <= NUM_INNER; i++ ) {
+      const uint64_t offset = last * i / (NUM_INNER + 1);
+      offsets.push_back(offset - offset % BLOCK_ALIGN);
+    }
+    offsets.push_back(last);
+
+    return offsets;
+  }
+
+  std::string toHexString(const uint64_t value)
+  {
+    constexpr char HEX[] = "0123456789abcdef";
+
+    std::string result(2 * sizeof(value), '0');
+    for( std::size_t i = 0; i < result.size(); i++ ) {
+      result[result.size() - 1 - i] = HEX[(value >> (4 * i)) & 0xF];
+    }
+
+    return result;
+  }
+
+} // namespace impl_fingerprint
+
+////// Public ////////////////////////////////////////////////////////////////
+
+std::string fingerprint(const std::filesystem::path& filename, const uint64_t size)
+{
+  using namespace impl_fingerprint;
+
+  try {
+    std::ifstream file(filename, std::ios::binary);
+    if( !file ) {
+      return std::string{};
+    }
+
+    Buffer buffer(BLOCK_SIZE);
+
+    uint64_t hash = update(FNV_OFFSET, size);
+    for( const uint64_t offset : sampleOffsets(size) ) {
+      const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(BLOCK_SIZE, size - offset));
+
+      file.seekg(static_cast<std::streamoff>(offset));
+      if( !file.read(buffer.data(), static_cast<std::streamsize>(count)) ) {
+        return std::string{};
+      }
+
+      hash = update(hash, offset);
+      hash = update(hash, buffer.data(), count);
+    } // For Each Sample
+
+    return toHexString(hash);
+  } catch( ... ) {
+  }
+
+  return std::string{};
+}
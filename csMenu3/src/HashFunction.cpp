@@ -0,0 +1,173 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <fstream>
+#include <vector>
+
+#include <cs/Convert/BufferUtil.h>
+#include <cs/Crypto/CryptoUtil.h>
+#include <cs/Crypto/Hash.h>
+
+#include "HashFunction.h"
+
+#include "XXH3.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_hashfunc {
+
+  namespace fs = std::filesystem;
+
+  constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
+
+  cs::Hash::Function toCryptoHash(const HashFunction func)
+  {
+    if( func == HashFunction::CRC32 ) {
+      return cs::Hash::CRC32;
+    } else if( func == HashFunction::MD5 ) {
+      return cs::Hash::MD5;
+    } else if( func == HashFunction::SHA1 ) {
+      return cs::Hash::SHA1;
+    } else if( func == HashFunction::SHA224 ) {
+      return cs::Hash::SHA224;
+    } else if( func == HashFunction::SHA256 ) {
+      return cs::Hash::SHA256;
+    } else if( func == HashFunction::SHA384 ) {
+      return cs::Hash::SHA384;
+    } else if( func == HashFunction::SHA512 ) {
+      return cs::Hash::SHA512;
+    }
+    return cs::Hash::Invalid;
+  }
+
+  void appendHex(std::string& result, const uint64_t value)
+  {
+    constexpr char HEX[] = "0123456789abcdef";
+
+    for( int shift = 60; shift >= 0; shift -= 4 ) {
+      result.push_back(HEX[(value >> shift) & 0xF]);
+    }
+  }
+
+  std::string cryptoDigest(const fs::path& filename, const cs::Hash::Function func)
+  {
+    cs::File file;
+    if( !file.open(filename) ) {
+      return std::string{};
+    }
+
+    const cs::Buffer bindigest = cs::sum(file, func);
+
+    return cs::toString(bindigest);
+  }
+
+  /*
+   * NOTE: The digest is formatted in xxHash's canonical (big-endian) form,
+   *       i.e. as printed by xxhsum; for XXH3-128 the high half comes first.
+   */
+
+  std::string xxh3Digest(const fs::path& filename, const HashFunction func)
+  {
+    try {
+      std::ifstream file(filename, std::ios::binary);
+      if( !file ) {
+        return std::string{};
+      }
+
+      std::vector<char> buffer(BLOCK_SIZE);
+
+      XXH3 state;
+      while( file ) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        state.update(buffer.data(), static_cast<std::size_t>(file.gcount()));
+      }
+
+      if( !file.eof() ) { // Read error
+        return std::string{};
+      }
+
+      std::string result;
+      if( func == HashFunction::XXH3_128 ) {
+        const XXH3_128 hash = state.digest128();
+        appendHex(result, hash.high);
+        appendHex(result, hash.low);
+      } else {
+        appendHex(result, state.digest64());
+      }
+
+      return result;
+    } catch( ... ) {
+    }
+
+    return std::string{};
+  }
+
+} // namespace impl_hashfunc
+
+////// Public ////////////////////////////////////////////////////////////////
+
+HashFunction idToHashFunction(const CommandId id)
+{
+  if( id == Command::HashCrc32 ) {
+    return HashFunction::CRC32;
+  } else if( id == Command::HashMd5 ) {
+    return HashFunction::MD5;
+  } else if( id == Command::HashSha1 ) {
+    return HashFunction::SHA1;
+  } else if( id == Command::HashSha224 ) {
+    return HashFunction::SHA224;
+  } else if( id == Command::HashSha256 ) {
+    return HashFunction::SHA256;
+  } else if( id == Command::HashSha384 ) {
+    return HashFunction::SHA384;
+  } else if( id == Command::HashSha512 ) {
+    return HashFunction::SHA512;
+  } else if( id == Command::HashXxh3_64 ) {
+    return HashFunction::XXH3_64;
+  } else if( id == Command::HashXxh3_128 ) {
+    return HashFunction::XXH3_128;
+  }
+  return HashFunction::Invalid;
+}
+
+std::string digest(const std::filesystem::path& filename, const HashFunction func)
+{
+  if( func == HashFunction::XXH3_64 || func == HashFunction::XXH3_128 ) {
+    return impl_hashfunc::xxh3Digest(filename, func);
+  }
+
+  const cs::Hash::Function cryptoFunc = impl_hashfunc::toCryptoHash(func);
+  if( cryptoFunc == cs::Hash::Invalid ) {
+    return std::string{};
+  }
+
+  return impl_hashfunc::cryptoDigest(filename, cryptoFunc);
+}
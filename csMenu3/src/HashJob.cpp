@@ -0,0 +1,183 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "HashJob.h"
+
+#include "FileName.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_hashjob {
+
+  struct Entry {
+    Entry() noexcept
+      : future{promise.get_future().share()}
+    {
+    }
+
+    std::promise<std::string> promise{};
+    std::shared_future<std::string> future{};
+    bool is_claimed{false};
+    std::size_t numRefs{0};
+  };
+
+  using EntryPtr = std::shared_ptr<Entry>;
+
+  struct Registry {
+    std::mutex mutex{};
+    std::map<std::wstring, EntryPtr> entries{};
+  };
+
+  Registry& registry()
+  {
+    static Registry instance;
+    return instance;
+  }
+
+} // namespace impl_hashjob
+
+////// public ////////////////////////////////////////////////////////////////
+
+HashJob::HashJob(const HashFunction func, const cs::PathList& files,
+                 const FileSnapshotPtr& snapshot) noexcept
+  : _func{func}
+  , _snapshot{snapshot}
+{
+  impl_hashjob::Registry& reg = impl_hashjob::registry();
+
+  try {
+    _keys.reserve(files.size());
+    for( const std::filesystem::path& filename : files ) {
+      _keys.push_back(key(filename));
+    }
+
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    for( const std::wstring& k : _keys ) {
+      impl_hashjob::EntryPtr& entry = reg.entries[k];
+      if( !entry ) {
+        entry = std::make_shared<impl_hashjob::Entry>();
+      }
+      entry->numRefs += 1;
+    }
+  } catch( ... ) {
+    _keys.clear(); // NOTE: digest() falls back to computing on its own.
+  }
+}
+
+HashJob::~HashJob() noexcept
+{
+  impl_hashjob::Registry& reg = impl_hashjob::registry();
+
+  const std::lock_guard<std::mutex> lock(reg.mutex);
+  for( const std::wstring& k : _keys ) {
+    auto iter = reg.entries.find(k);
+    if( iter == reg.entries.end() ) {
+      continue;
+    }
+
+    iter->second->numRefs -= 1;
+    if( iter->second->numRefs < 1 ) {
+      reg.entries.erase(iter);
+    }
+  }
+}
+
+std::string HashJob::digest(const std::filesystem::path& filename, const Compute& compute) const
+{
+  impl_hashjob::Registry& reg = impl_hashjob::registry();
+
+  impl_hashjob::EntryPtr entry;
+  bool is_owner = false;
+  try {
+    const std::wstring k = key(filename);
+
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    auto iter = reg.entries.find(k);
+    if( iter != reg.entries.end() ) {
+      entry = iter->second;
+      if( !entry->is_claimed ) {
+        entry->is_claimed = is_owner = true;
+      }
+    }
+  } catch( ... ) {
+    entry.reset();
+  }
+
+  // (1) Not registered: Compute on our own //////////////////////////////////
+
+  if( !entry ) {
+    return compute();
+  }
+
+  // (2) Someone else is (or was) computing: Wait for the result /////////////
+
+  if( !is_owner ) {
+    return entry->future.get();
+  }
+
+  // (3) We are computing: Publish the result ////////////////////////////////
+
+  std::string result;
+  try {
+    result = compute();
+  } catch( ... ) {
+    result.clear();
+  }
+  entry->promise.set_value(result);
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+std::wstring HashJob::key(const std::filesystem::path& filename) const
+{
+  // NOTE: Windows' file names are case-insensitive; cf. foldFileName().
+  std::wstring result = foldFileName(filename.lexically_normal().wstring());
+
+  const fileinfo::Info info = _snapshot
+                             ? _snapshot->info(filename)
+                             : fileinfo::query(filename.c_str());
+
+  result += L'|';
+  result += std::to_wstring(info.size);
+  result += L'|';
+  result += std::to_wstring(info.mtime);
+  result += L'|';
+  result += std::to_wstring(static_cast<unsigned>(_func));
+
+  return result;
+}
@@ -33,6 +33,7 @@
 
 #include "CommandEnum.h"
 #include "CommandInvoke.h"
+#include "CommandSeparator.h"
 #include "csMenu3Resource.h"
 
 ////// Private ///////////////////////////////////////////////////////////////
@@ -54,6 +55,12 @@ namespace impl_hash {
     menu->append(winrt::make<CommandInvoke>(Command::HashSha256));
     menu->append(winrt::make<CommandInvoke>(Command::HashSha384));
     menu->append(winrt::make<CommandInvoke>(Command::HashSha512));
+
+    menu->append(winrt::make<CommandSeparator>());
+
+    menu->append(winrt::make<CommandInvoke>(Command::HashXxh3_64));
+    menu->append(winrt::make<CommandInvoke>(Command::HashXxh3_128));
+    menu->append(winrt::make<CommandInvoke>(Command::HashFingerprint));
   }
 
 } // namespace impl_hash
@@ -29,16 +29,28 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <cs/Concurrent/MapReduce.h>
-#include <cs/Convert/BufferUtil.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
 #include <cs/Core/Container.h>
-#include <cs/Crypto/CryptoUtil.h>
-#include <cs/Text/StringUtil.h>
 
 #include "HashWorker.h"
 
+#include "FileName.h"
+#include "Fingerprint.h"
+#include "HashJob.h"
+#include "ThreadPool.h"
 #include "Util.h"
 #include "Win32/Clipboard.h"
+#include "Win32/FileOp.h"
 #include "Win32/Message.h"
 #include "Win32/MessageBox.h"
 #include "Win32/ProgressBar.h"
@@ -46,64 +58,570 @@
 
 ////// Imports ///////////////////////////////////////////////////////////////
 
-namespace conc = cs::concurrent;
-
 extern HANDLE_t getInstDLL(); // main.cpp
 
 ////// Private ///////////////////////////////////////////////////////////////
 
 namespace impl_hash {
 
+  namespace fs = std::filesystem;
+
+  using Clock = std::chrono::steady_clock;
+
+  // Inline Fast Path ////////////////////////////////////////////////////////
+
+  constexpr std::size_t INLINE_MAX_FILES = 16;
+  constexpr uint64_t INLINE_MAX_BYTES    = 32 * 1024 * 1024;
+
+  // Show progress if the inline fast path takes longer than this...
+  constexpr std::chrono::milliseconds INLINE_MAX_DURATION{200};
+
+  bool isSmallJob(const WorkContext& ctx)
+  {
+    if( ctx.files.size() > INLINE_MAX_FILES ) {
+      return false;
+    }
+
+    uint64_t sum = 0;
+    for( const fs::path& filename : ctx.files ) {
+      sum += ctx.size(filename);
+      if( sum > INLINE_MAX_BYTES ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Manifest ////////////////////////////////////////////////////////////////
+
+  // A manifest's line & its file's index in WorkContext::files.
+  struct ManifestEntry {
+    std::size_t index{0};
+    std::wstring text{};
+  };
+
+  using Manifest = std::vector<ManifestEntry>;
+
+  /*
+   * NOTE: The line is assembled in place; the (ASCII) digest is copied
+   *       w/o an intermediate wide string, the filename w/o conversion.
+   */
+
+  std::wstring manifestLine(const std::string& digest, const fs::path& filename)
+  {
+    if( digest.empty() ) {
+      return std::wstring{};
+    }
+
+    constexpr std::wstring_view NAME_SEP(L" *");
+
+    std::wstring result;
+    try {
+      const fs::path name = filename.filename();
+
+      result.reserve(digest.size() + NAME_SEP.size() + name.native().size() + EOL.size());
+      appendAscii(result, digest);
+      result += NAME_SEP;
+      result += name.native();
+      result += EOL;
+    } catch( ... ) {
+      result.clear();
+    }
+
+    return result;
+  }
+
+  /*
+   * NOTE: Entries arrive in order of completion; they are joined in the
+   *       selection's (sorted) order, i.e. by their files' indices.
+   */
+
+  std::wstring joinManifest(Manifest& manifest)
+  {
+    std::sort(manifest.begin(), manifest.end(),
+              [](const ManifestEntry& a, const ManifestEntry& b) -> bool {
+                return a.index < b.index;
+              });
+
+    std::size_t length = 0;
+    for( const ManifestEntry& entry : manifest ) {
+      length += entry.text.size();
+    }
+
+    std::wstring result;
+    try {
+      result.reserve(length);
+      for( const ManifestEntry& entry : manifest ) {
+        result += entry.text;
+      }
+    } catch( ... ) {
+      return std::wstring{};
+    }
+
+    return result;
+  }
+
+  // Reduce //////////////////////////////////////////////////////////////////
+
   struct HashReduce {
     HashReduce() noexcept
     {
     }
 
-    void operator()(std::wstring& result, const std::wstring& hash) const
+    void operator()(Manifest& result, ManifestEntry&& entry) const
+    {
+      if( entry.text.empty() ) {
+        return;
+      }
+
+      try {
+        result.push_back(std::move(entry));
+      } catch( ... ) {
+        return;
+      }
+    }
+
+    void operator()(Manifest& result, Manifest&& other) const
+    {
+      try {
+        result.insert(result.end(),
+                      std::make_move_iterator(other.begin()),
+                      std::make_move_iterator(other.end()));
+      } catch( ... ) {
+        return;
+      }
+    }
+  };
+
+  // Sidecar /////////////////////////////////////////////////////////////////
+
+  std::wstring sidecarSuffix(const HashFunction func)
+  {
+    if( func == HashFunction::CRC32 ) {
+      return std::wstring{L".crc32"};
+    } else if( func == HashFunction::MD5 ) {
+      return std::wstring{L".md5"};
+    } else if( func == HashFunction::SHA1 ) {
+      return std::wstring{L".sha1"};
+    } else if( func == HashFunction::SHA224 ) {
+      return std::wstring{L".sha224"};
+    } else if( func == HashFunction::SHA256 ) {
+      return std::wstring{L".sha256"};
+    } else if( func == HashFunction::SHA384 ) {
+      return std::wstring{L".sha384"};
+    } else if( func == HashFunction::SHA512 ) {
+      return std::wstring{L".sha512"};
+    } else if( func == HashFunction::XXH3_64 ) {
+      return std::wstring{L".xxh3"};
+    } else if( func == HashFunction::XXH3_128 ) {
+      return std::wstring{L".xxh128"};
+    }
+    return std::wstring{L".hash"};
+  }
+
+  bool isSidecarCurrent(const fs::path& filename, const fs::path& sidecar)
+  {
+    std::error_code ec;
+
+    const fs::file_time_type timeSidecar = fs::last_write_time(sidecar, ec);
+    if( ec ) {
+      return false;
+    }
+
+    const fs::file_time_type timeFile = fs::last_write_time(filename, ec);
+    if( ec ) {
+      return false;
+    }
+
+    return timeSidecar > timeFile;
+  }
+
+  /*
+   * NOTE: The sidecar is written to a new, uniquely named temporary file
+   *       first and then renamed into place, so readers never observe a
+   *       partially written digest; concurrent jobs never share the file.
+   *       The format follows coreutils' "<digest> *<filename>" (binary mode),
+   *       with the filename encoded as UTF-8.
+   */
+
+  bool writeSidecar(const fs::path& sidecar, const std::string& strdigest,
+                    const fs::path& filename)
+  {
+    std::string content;
+    try {
+      const std::u8string name = filename.filename().u8string();
+
+      content  = strdigest;
+      content += " *";
+      content.append(reinterpret_cast<const char *>(name.data()), name.size());
+      content += '\n';
+    } catch( ... ) {
+      return false;
+    }
+
+    const std::wstring temp = fileop::writeTemporary(sidecar.c_str(), content);
+    if( temp.empty() ) {
+      return false;
+    }
+
+    std::error_code ec;
+    fs::rename(temp, sidecar, ec);
+    if( ec ) {
+      fs::remove(temp, ec);
+      return false;
+    }
+
+    return true;
+  }
+
+  // Watchdog ////////////////////////////////////////////////////////////////
+
+  // The Watchdog's timer exits after being idle for this long...
+  constexpr std::chrono::seconds WATCHDOG_IDLE_TIMEOUT{10};
+
+  /*
+   * NOTE: The Watchdog shows the inline fast path's progress, once it takes
+   *       longer than INLINE_MAX_DURATION; e.g. while a single large file is
+   *       read from a slow volume.
+   *
+   *       All Watchdogs share one timer, i.e. a job of the ThreadPool, which
+   *       is started on demand & exits once idle. Only a Watchdog whose
+   *       deadline passes gets a job of its own, which owns the progress
+   *       window & runs its message loop.
+   *
+   *       The watching job takes the mutex only while the window is not
+   *       published yet or already destroyed; hence, the fast path may
+   *       message the window while holding the mutex.
+   */
+
+  class Watchdog {
+  public:
+    Watchdog(const std::size_t numFiles) noexcept
     {
       try {
-        result += hash;
+        _state           = std::make_shared<State>();
+        _state->numFiles = numFiles;
+        _state->deadline = Clock::now() + INLINE_MAX_DURATION;
+
+        if( !schedule(_state) ) {
+          _state.reset();
+        }
       } catch( ... ) {
+        _state.reset();
+      }
+    }
+
+    ~Watchdog() noexcept
+    {
+      finish();
+    }
+
+    void finish()
+    {
+      if( !_state ) {
+        return;
+      }
+
+      {
+        const std::lock_guard<std::mutex> lock(_state->mutex);
+        if( _state->is_done ) {
+          return;
+        }
+        _state->is_done = true;
+
+        if( _state->progress != nullptr ) {
+          _state->progress->close();
+        }
+      }
+      _state->changed.notify_all();
+    }
+
+    void step() const
+    {
+      if( !_state ) {
+        return;
+      }
+
+      const std::lock_guard<std::mutex> lock(_state->mutex);
+      _state->numDone++;
+
+      if( _state->progress != nullptr ) {
+        _state->progress->step();
+      }
+    }
+
+  private:
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+
+    struct State {
+      std::mutex mutex;
+      std::condition_variable changed;
+      Clock::time_point deadline{};
+      std::size_t numFiles{0};
+      std::size_t numDone{0};
+      const ProgressBar *progress{nullptr};
+      bool is_done{false};
+    };
+
+    using StatePtr = std::shared_ptr<State>;
+
+    /*
+     * NOTE: All deadlines are INLINE_MAX_DURATION after their Watchdog's
+     *       construction; hence, the queue is ordered by deadline.
+     */
+
+    struct Timer {
+      std::mutex mutex;
+      std::condition_variable changed;
+      std::deque<StatePtr> queue;
+      bool is_running{false};
+    };
+
+    static Timer& timer()
+    {
+      static Timer t;
+      return t;
+    }
+
+    static bool schedule(const StatePtr& state)
+    {
+      Timer& t = timer();
+
+      {
+        const std::lock_guard<std::mutex> lock(t.mutex);
+        t.queue.push_back(state);
+
+        if( !t.is_running ) {
+          t.is_running = ThreadPool::instance().launch([]() -> void {
+            tick();
+          });
+          if( !t.is_running ) {
+            t.queue.pop_back();
+            return false;
+          }
+        }
+      }
+      t.changed.notify_one();
+
+      return true;
+    }
+
+    static void tick()
+    {
+      Timer& t = timer();
+
+      std::unique_lock<std::mutex> lock(t.mutex);
+      while( true ) {
+        // (1) Wait for a Deadline ///////////////////////////////////////////
+
+        if( t.queue.empty() ) {
+          const bool is_scheduled = t.changed.wait_for(lock, WATCHDOG_IDLE_TIMEOUT, [&]() -> bool {
+            return !t.queue.empty();
+          });
+          if( !is_scheduled ) {
+            break;
+          }
+        }
+
+        const Clock::time_point deadline = t.queue.front()->deadline;
+        if( Clock::now() < deadline ) {
+          t.changed.wait_until(lock, deadline);
+          continue;
+        }
+
+        const StatePtr state = std::move(t.queue.front());
+        t.queue.pop_front();
+
+        // (2) Watch the Overdue Fast Path ///////////////////////////////////
+
+        lock.unlock();
+        if( !isDone(*state) ) {
+          ThreadPool::instance().launch([state]() -> void {
+            watch(*state);
+          });
+        }
+        lock.lock();
+      } // Forever
+
+      t.is_running = false;
+    }
+
+    static bool isDone(State& state)
+    {
+      const std::lock_guard<std::mutex> lock(state.mutex);
+      return state.is_done;
+    }
+
+    static void watch(State& state)
+    {
+      // (1) Show Progress ///////////////////////////////////////////////////
+
+      if( !window::makeGUIThread() ) {
+        return;
+      }
+
+      ProgressBarPtr progress = ProgressBar::make(getInstDLL(), 480, 48);
+      if( !progress ) {
         return;
       }
+
+      progress->setPostQuitOnDestroy(true);
+      progress->setRange(0, static_cast<int>(state.numFiles));
+
+      {
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        if( state.is_done ) {
+          return;
+        }
+
+        for( std::size_t i = 0; i < state.numDone; i++ ) {
+          progress->step();
+        }
+        state.progress = progress.get();
+      }
+
+      progress->show();
+      message::loop();
+
+      // (2) Release the Window, once the Fast Path is Done //////////////////
+
+      std::unique_lock<std::mutex> lock(state.mutex);
+      state.changed.wait(lock, [&]() -> bool {
+        return state.is_done;
+      });
+      state.progress = nullptr;
     }
+
+    StatePtr _state{};
   };
 
+  // Worker //////////////////////////////////////////////////////////////////
+
   class Worker {
   public:
-    Worker(const cs::Hash::Function func,
+    Worker(const HashFunction func,
+           const HashOutput output,
+           const HashJob *job,
            const ProgressBar *progress = nullptr) noexcept
       : _func{func}
+      , _output{output}
+      , _job{job}
       , _progress{progress}
     {
+      if( _output == HashOutput::Sidecar ) {
+        _suffix = sidecarSuffix(_func);
+      }
     }
 
-    ~Worker()
+    Worker(const HashFunction func,
+           const HashOutput output,
+           const HashJob *job,
+           const Watchdog *watchdog) noexcept
+      : Worker(func, output, job)
     {
+      _watchdog = watchdog;
     }
 
-    std::wstring operator()(const std::filesystem::path& filename) const
+    ~Worker()
     {
-      std::wstring result;
+    }
 
-      cs::File file;
-      if( file.open(filename) ) {
-        const cs::Buffer bindigest  = cs::sum(file, _func);
-        const std::string strdigest = cs::toString(bindigest);
+    ManifestEntry operator()(const WorkFile& file) const
+    {
+      ManifestEntry result{file.index, std::wstring{}};
 
-        result = cs::widen(strdigest);
+      if( _output == HashOutput::Sidecar ) {
+        sidecar(file.filename);
+      } else {
+        result.text = line(file.filename);
       }
 
-      if( !result.empty() ) {
-        try {
-          result += L" *";
-          result += filename.filename();
-          result += EOL;
-        } catch( ... ) {
-          result.clear();
+      if( _progress != nullptr ) {
+        _progress->step();
+
+        if( _progress->position() == _progress->range().second ) {
+          _progress->close();
         }
       }
 
+      if( _watchdog != nullptr ) {
+        _watchdog->step();
+      }
+
+      return result;
+    }
+
+  private:
+    Worker() noexcept = delete;
+
+    std::string compute(const fs::path& filename) const
+    {
+      if( _job == nullptr ) {
+        return digest(filename, _func);
+      }
+
+      return _job->digest(filename, [this, &filename]() -> std::string {
+        return digest(filename, _func);
+      });
+    }
+
+    std::wstring line(const fs::path& filename) const
+    {
+      return manifestLine(compute(filename), filename);
+    }
+
+    void sidecar(const fs::path& filename) const
+    {
+      if( filename.extension() == _suffix ) { // Never hash a sidecar itself!
+        return;
+      }
+
+      fs::path sidecar = filename;
+      sidecar += _suffix;
+
+      if( isSidecarCurrent(filename, sidecar) ) {
+        return;
+      }
+
+      const std::string strdigest = compute(filename);
+      if( strdigest.empty() ) {
+        return;
+      }
+
+      writeSidecar(sidecar, strdigest, filename);
+    }
+
+    HashFunction _func{HashFunction::Invalid};
+    HashOutput _output{HashOutput::Clipboard};
+    const HashJob *_job{nullptr};
+    const ProgressBar *_progress{nullptr};
+    const Watchdog *_watchdog{nullptr};
+    std::wstring _suffix{};
+  };
+
+  // Fingerprint /////////////////////////////////////////////////////////////
+
+  class FingerprintWorker {
+  public:
+    FingerprintWorker(const WorkContext *ctx,
+                      const ProgressBar *progress = nullptr) noexcept
+      : _ctx{ctx}
+      , _progress{progress}
+    {
+    }
+
+    ~FingerprintWorker()
+    {
+    }
+
+    ManifestEntry operator()(const WorkFile& file) const
+    {
+      const uint64_t size = _ctx->size(file.filename);
+
+      ManifestEntry result{file.index, manifestLine(fingerprint(file.filename, size), file.filename)};
+
       if( _progress != nullptr ) {
         _progress->step();
 
@@ -116,21 +634,64 @@ namespace impl_hash {
     }
 
   private:
-    Worker() noexcept = delete;
-
-    cs::Hash::Function _func{cs::Hash::Invalid};
+    const WorkContext *_ctx{nullptr};
     const ProgressBar *_progress{nullptr};
   };
 
+  // Volumes /////////////////////////////////////////////////////////////////
+
+  using Futures = std::vector<std::future<Manifest>>;
+
+  /*
+   * NOTE: Each volume is read concurrently to the others, using its own
+   *       number of threads; cf. WorkContext::volumes(). The volumes must
+   *       outlive the futures.
+   */
+
+  template <typename MapFunc>
+  Futures mapReduceVolumes(const WorkVolumes& volumes, const MapFunc& map)
+  {
+    Futures result;
+    try {
+      for( const WorkVolume& volume : volumes ) {
+        result.push_back(ThreadPool::instance().mapReduceAsync<Manifest>(volume.files.begin(), volume.files.end(),
+                                                                         volume.numThreads, map, HashReduce()));
+      }
+    } catch( ... ) {
+      for( std::future<Manifest>& future : result ) {
+        future.wait();
+      }
+      throw;
+    }
+
+    return result;
+  }
+
+  void reduceVolumes(Manifest& result, Futures& futures)
+  {
+    const HashReduce reduce;
+
+    for( std::future<Manifest>& future : futures ) {
+      reduce(result, future.get());
+    }
+  }
+
 } // namespace impl_hash
 
-using Reduce = impl_hash::HashReduce;
-using Worker = impl_hash::Worker;
+using FingerprintWorker = impl_hash::FingerprintWorker;
+using Reduce            = impl_hash::HashReduce;
+using Worker            = impl_hash::Worker;
 
 ////// Public ////////////////////////////////////////////////////////////////
 
-void hash_work(const cs::Hash::Function func, WorkContext ctx)
+void fingerprint_work(WorkContext ctx)
 {
+  const WorkVolumes volumes = ctx.volumes(ctx.files.begin(), ctx.files.end());
+  if( volumes.empty() ) {
+    messagebox::error(L"WorkContext::volumes()");
+    return;
+  }
+
   if( !window::makeGUIThread() ) {
     messagebox::error(L"makeGUIThread()");
     return;
@@ -146,10 +707,85 @@ void hash_work(const cs::Hash::Function func, WorkContext ctx)
   progress->setRange(0, static_cast<int>(ctx.files.size()));
   progress->show();
 
-  auto future = conc::mapReduceUnsortedAsync<std::wstring>(ctx.numThreads, ctx.files.begin(), ctx.files.end(),
-                                                           Worker(func, progress.get()), Reduce());
+  impl_hash::Futures futures = impl_hash::mapReduceVolumes(volumes, FingerprintWorker(&ctx, progress.get()));
   message::loop();
-  const std::wstring result = future.get();
+  impl_hash::Manifest manifest;
+  impl_hash::reduceVolumes(manifest, futures);
+  const std::wstring result = impl_hash::joinManifest(manifest);
+
+  messagebox::information(L"Done! (Fingerprint)");
+
+  setClipboardText(result.data());
+}
+
+void hash_work(const HashFunction func, const HashOutput output, WorkContext ctx)
+{
+  const HashJob job(func, ctx.files, ctx.snapshot);
+
+  impl_hash::Manifest manifest;
+
+  std::optional<impl_hash::Watchdog> watchdog;
+
+  // (1) Small jobs are hashed inline; progress is shown by the Watchdog /////
+
+  auto first = ctx.files.begin();
+  if( impl_hash::isSmallJob(ctx) ) {
+    watchdog.emplace(ctx.files.size());
+
+    const Worker worker(func, output, &job, &*watchdog);
+    const Reduce reduce;
+
+    const impl_hash::Clock::time_point start = impl_hash::Clock::now();
+    for( std::size_t index = 0; first != ctx.files.end(); ++first, ++index ) {
+      if( impl_hash::Clock::now() - start > impl_hash::INLINE_MAX_DURATION ) {
+        break;
+      }
+      reduce(manifest, worker(WorkFile{*first, index}));
+    }
+  }
+
+  // (2) Remaining files are hashed in parallel, showing progress ////////////
+
+  if( first != ctx.files.end() ) {
+    const WorkVolumes volumes = ctx.volumes(first, ctx.files.end());
+    if( volumes.empty() ) {
+      messagebox::error(L"WorkContext::volumes()");
+      return;
+    }
+
+    if( watchdog ) { // The Watchdog's window, if any, continues to show progress
+      impl_hash::Futures futures = impl_hash::mapReduceVolumes(volumes, Worker(func, output, &job, &*watchdog));
+      impl_hash::reduceVolumes(manifest, futures);
+    } else {
+      if( !window::makeGUIThread() ) {
+        messagebox::error(L"makeGUIThread()");
+        return;
+      }
+
+      ProgressBarPtr progress = ProgressBar::make(getInstDLL(), 480, 48);
+      if( !progress ) {
+        messagebox::error(L"ProgressBar::make()");
+        return;
+      }
+
+      progress->setPostQuitOnDestroy(true);
+      progress->setRange(0, static_cast<int>(std::distance(first, ctx.files.end())));
+      progress->show();
+
+      impl_hash::Futures futures = impl_hash::mapReduceVolumes(volumes, Worker(func, output, &job, progress.get()));
+      message::loop();
+      impl_hash::reduceVolumes(manifest, futures);
+    }
+  }
+
+  watchdog.reset(); // Closes its window, if any
+
+  if( output == HashOutput::Sidecar ) {
+    messagebox::information(L"Done! (Hash, sidecar files)");
+    return;
+  }
+
+  const std::wstring result = impl_hash::joinManifest(manifest);
 
   messagebox::information(L"Done! (Hash)");
 
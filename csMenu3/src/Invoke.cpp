@@ -30,20 +30,27 @@
 *****************************************************************************/
 
 #include <filesystem>
-#include <thread>
+#include <functional>
 
 #include <cs/System/FileSystem.h>
-#include <cs/Text/StringUtil.h>
 
 #include "Invoke.h"
 
+#include "CanonicalPath.h"
+#include "DirectoryWalker.h"
 #include "HashWorker.h"
+#include "ListFormat.h"
 #include "MenuFlags.h"
 #include "RenameDialog.h"
+#include "RenameEngine.h"
+#include "RenamePlan.h"
 #include "ScriptWorker.h"
+#include "ThreadPool.h"
+#include "TuneWorker.h"
+#include "UncResolver.h"
 #include "Util.h"
 #include "Win32/Clipboard.h"
-#include "Win32/Network.h"
+#include "Win32/MessageBox.h"
 
 ////// Imports ///////////////////////////////////////////////////////////////
 
@@ -57,57 +64,34 @@ namespace impl_invoke {
 
   constexpr std::size_t ONE = 1;
 
-  constexpr wchar_t SEP_NATIVE = L'\\';
-  constexpr wchar_t SEP_UNIX   = L'/';
-
-  void appendFilename(std::wstring& text, const std::wstring& filename, const CommandId id)
+  // Runs job on a thread of its own; cf. ThreadPool::launch().
+  void launch(ThreadPool::Task job)
   {
-    constexpr std::size_t NPOS = std::wstring::npos;
-
-    if( filename.empty() ) {
-      return;
-    }
-
-    const std::size_t pos = filename.rfind(SEP_NATIVE);
-    if( pos != NPOS ) {
-      if( id == Command::List ) {
-        text.append(filename.data() + pos + ONE);
-      } else if( id == Command::ListPathTabular ) {
-        text.append(filename.data(), pos + ONE);
-        text.append(ONE, L'\t');
-        text.append(filename.data() + pos + ONE);
-      } else { // Command::ListPath  AKA  "as-is"
-        text.append(filename);
-      }
-    } else {
-      text.append(filename);
+    if( !ThreadPool::instance().launch(std::move(job)) ) {
+      messagebox::error(L"ThreadPool::launch()");
     }
+  }
 
-    if( cs::isDirectory(filename) ) {
-      text.append(ONE, SEP_NATIVE);
+  void invokeCalibrate(const cs::PathList& selection, const FileSnapshotPtr& snapshot)
+  {
+    WorkContext ctx;
+    ctx.snapshot = snapshot;
+    if( !ctx.setFiles(selection) ) {
+      return;
     }
 
-    text += EOL;
+    launch(std::bind(calibrate_work, std::move(ctx)));
   }
 
-  cs::Hash::Function idToHashFunction(const CommandId id)
+  void invokeFingerprint(const cs::PathList& selection, const FileSnapshotPtr& snapshot)
   {
-    if( id == Command::HashCrc32 ) {
-      return cs::Hash::CRC32;
-    } else if( id == Command::HashMd5 ) {
-      return cs::Hash::MD5;
-    } else if( id == Command::HashSha1 ) {
-      return cs::Hash::SHA1;
-    } else if( id == Command::HashSha224 ) {
-      return cs::Hash::SHA224;
-    } else if( id == Command::HashSha256 ) {
-      return cs::Hash::SHA256;
-    } else if( id == Command::HashSha384 ) {
-      return cs::Hash::SHA384;
-    } else if( id == Command::HashSha512 ) {
-      return cs::Hash::SHA512;
-    }
-    return cs::Hash::Invalid;
+    WorkContext ctx;
+    ctx.snapshot = snapshot;
+    if( !ctx.setFiles(selection) ) {
+      return;
+    }
+
+    launch(std::bind(fingerprint_work, std::move(ctx)));
   }
 
   void invokeFlags(const CommandId id)
@@ -120,88 +104,170 @@ namespace impl_invoke {
       flags.toggle(MenuFlag::ParallelExecution);
     } else if( id == Command::CheckResolveUncPaths ) {
       flags.toggle(MenuFlag::ResolveUncPaths);
+      UncResolver::invalidate();
     } else if( id == Command::CheckUnixPathSeparators ) {
       flags.toggle(MenuFlag::UnixPathSeparators);
+    } else if( id == Command::CheckHashSidecarFiles ) {
+      flags.toggle(MenuFlag::HashSidecarFiles);
     }
 
     writeFlags(flags);
   }
 
-  void invokeHash(const CommandId id, const cs::PathList& selection)
+  void invokeHash(const CommandId id, const cs::PathList& selection, const FileSnapshotPtr& snapshot)
   {
     WorkContext ctx;
+    ctx.snapshot = snapshot;
 
     if( !ctx.setFiles(selection) ) {
       return;
     }
 
-    const cs::Hash::Function func = idToHashFunction(id);
-    if( func == cs::Hash::Invalid ) {
+    const HashFunction func = idToHashFunction(id);
+    if( func == HashFunction::Invalid ) {
       return;
     }
 
-    std::thread(hash_work, func, std::move(ctx)).detach();
+    const HashOutput output = readFlags().testAny(MenuFlag::HashSidecarFiles)
+                              ? HashOutput::Sidecar
+                              : HashOutput::Clipboard;
+
+    launch(std::bind(hash_work, func, output, std::move(ctx)));
   }
 
-  void invokeList(const CommandId id, const cs::PathList& selection)
+  void invokeList(const CommandId id, const Selection& selection, const FileSnapshotPtr& snapshot)
   {
-    if( selection.empty() ) {
+    if( selection.empty() || !snapshot ) {
       return;
     }
 
     const MenuFlags flags = readFlags();
     const bool is_unc     = flags.testAny(MenuFlag::ResolveUncPaths) && id != Command::List;
 
-    std::wstring text;
+    const bool is_canonical = id == Command::ListCanonical;
+
+    const cs::PathList canonical = is_canonical
+                                   ? canonicalPaths(selection, snapshot)
+                                   : cs::PathList{};
+    if( is_canonical && canonical.size() != selection.size() ) {
+      return;
+    }
+
+    const UncResolver unc = !is_unc
+                            ? UncResolver(cs::PathList{})
+                            : is_canonical
+                            ? UncResolver(canonical)
+                            : UncResolver(selection);
+
+    ListItems items;
     try {
-      for( const fs::path& item : selection ) {
-        std::wstring uncName;
-        if( is_unc && !(uncName = resolveUniversalName(item.wstring().data())).empty() ) {
-          appendFilename(text, uncName, id);
-        } else {
-          appendFilename(text, item.wstring(), id);
+      items.reserve(selection.size());
+
+      auto name = canonical.cbegin();
+      for( const Selection::Item& item : selection ) {
+        std::wstring filename = item.filename();
+
+        const fileinfo::Info info = snapshot->info(filename);
+        const bool is_dir         = info.type == fileinfo::Type::Directory;
+
+        if( is_canonical ) {
+          filename = (name++)->wstring();
         }
+
+        items.push_back(ListItem{unc.resolve(std::move(filename)), is_dir, info});
       } // For each item
+    } catch( ... ) {
+      return;
+    }
 
-      if( selection.size() == ONE && text.size() >= EOL.size() ) { // Remove trailing EOL
-        text.erase(text.size() - EOL.size());
-      }
+    const std::wstring text = formatList(id, items, flags.testAny(MenuFlag::UnixPathSeparators));
+    if( text.empty() ) {
+      return;
+    }
+
+    setClipboardText(text.data());
+  }
+
+  void listTree(const cs::PathList selection, const MenuFlags flags)
+  {
+    const bool is_unc  = flags.testAny(MenuFlag::ResolveUncPaths);
+    const bool is_unix = flags.testAny(MenuFlag::UnixPathSeparators);
+
+    const UncResolver unc(is_unc ? selection : cs::PathList{});
+
+    ListItems items;
+    try {
+      const std::size_t numThreads = ThreadPool::instance().budget();
+
+      walkDirectories(selection, numThreads, [&](const WalkEntry& entry) -> void {
+        const bool is_dir = entry.info.type == fileinfo::Type::Directory;
+        items.push_back(ListItem{unc.resolve(entry.filename), is_dir, entry.info});
+      });
     } catch( ... ) {
       return;
     }
 
-    if( flags.testAny(MenuFlag::UnixPathSeparators) ) {
-      cs::replaceAll(text, SEP_NATIVE, SEP_UNIX);
+    const std::wstring text = formatList(static_cast<CommandId>(Command::ListTree), items, is_unix);
+    if( text.empty() ) {
+      return;
     }
 
     setClipboardText(text.data());
   }
 
-  void invokeRename(const cs::PathList& selection)
+  void invokeListTree(const cs::PathList& selection)
   {
-    const cs::PathList files = cs::filter(selection, cs::PathListFlag::File);
-    if( files.empty() ) {
+    if( selection.empty() ) {
       return;
     }
 
-    RenameDialog d;
-    if( !d.exec(getInstDLL()) ) {
+    launch(std::bind(listTree, selection, readFlags()));
+  }
+
+  void renameFiles(const cs::PathList files, const Rename rename)
+  {
+    const RenameEngine engine(rename);
+    if( !engine.isValid() ) {
       return;
     }
 
-    const Rename rename = d.data;
-    if( !rename.isValid() ) {
+    RenamePlan plan;
+    if( !plan.plan(files, engine) ) {
       return;
     }
 
-    for( const std::filesystem::path& file : files ) {
-      rename(file);
+    const std::size_t numRenamed = plan.execute();
+    if( numRenamed + plan.count(RenamePlan::Status::Unchanged) == files.size() ) {
+      return;
     }
+
+    messagebox::warning(plan.report().data(), L"Rename");
   }
 
-  void invokeScript(const std::wstring& script, const cs::PathList& selection)
+  void invokeRename(const cs::PathList& selection, const FileSnapshotPtr& snapshot)
+  {
+    if( !snapshot ) {
+      return;
+    }
+
+    const cs::PathList files = snapshot->files(selection);
+    if( files.empty() ) {
+      return;
+    }
+
+    RenameDialog d(files);
+    if( !d.exec(getInstDLL()) ) {
+      return;
+    }
+
+    launch(std::bind(renameFiles, files, d.data));
+  }
+
+  void invokeScript(const std::wstring& script, const cs::PathList& selection,
+                    const FileSnapshotPtr& snapshot)
   {
     WorkContext ctx;
+    ctx.snapshot = snapshot;
     if( !ctx.setScript(script) || !ctx.setFiles(selection) ) {
       return;
     }
@@ -211,12 +277,16 @@ namespace impl_invoke {
     const bool is_parallel = ctx.numThreads > ONE && flags.testAny(MenuFlag::ParallelExecution);
 
     if( is_batch ) {
-      std::thread{batch_work, std::move(ctx)}.detach();
+      if( is_parallel ) {
+        launch(std::bind(parallel_batch_work, std::move(ctx)));
+      } else {
+        launch(std::bind(batch_work, std::move(ctx)));
+      }
     } else {
       if( is_parallel ) {
-        std::thread{parallel_work, std::move(ctx)}.detach();
+        launch(std::bind(parallel_work, std::move(ctx)));
       } else {
-        std::thread{sequential_work, std::move(ctx)}.detach();
+        launch(std::bind(sequential_work, std::move(ctx)));
       }
     }
   }
@@ -225,10 +295,19 @@ namespace impl_invoke {
 
 ////// Public ////////////////////////////////////////////////////////////////
 
-void invokeCommandId(const CommandId id, const std::wstring& script, const cs::PathList& selection)
+void invokeCommandId(const CommandId id, const std::wstring& script, const Selection& selection)
 {
-  if( id == Command::List || id == Command::ListPath || id == Command::ListPathTabular ) {
-    impl_invoke::invokeList(id, selection);
+  // Query the selection's attributes only once; cf. FileSnapshot.
+  const auto snapshot = [&]() -> FileSnapshotPtr {
+    return FileSnapshot::make(selection);
+  };
+
+  if( id == Command::List || id == Command::ListPath || id == Command::ListPathTabular ||
+      id == Command::ListCanonical ||
+      id == Command::ListDetailedCsv || id == Command::ListDetailedTsv || id == Command::ListDetailedJson ) {
+    impl_invoke::invokeList(id, selection, snapshot());
+  } else if( id == Command::ListTree ) {
+    impl_invoke::invokeListTree(selection.paths());
   } else if( id == Command::CheckBatchProcessing ) {
     impl_invoke::invokeFlags(id);
   } else if( id == Command::CheckParallelExecution ) {
@@ -237,11 +316,17 @@ void invokeCommandId(const CommandId id, const std::wstring& script, const cs::P
     impl_invoke::invokeFlags(id);
   } else if( id == Command::CheckUnixPathSeparators ) {
     impl_invoke::invokeFlags(id);
+  } else if( id == Command::CheckHashSidecarFiles ) {
+    impl_invoke::invokeFlags(id);
+  } else if( id == Command::CalibrateStorage ) {
+    impl_invoke::invokeCalibrate(selection.paths(), snapshot());
+  } else if( id == Command::HashFingerprint ) {
+    impl_invoke::invokeFingerprint(selection.paths(), snapshot());
   } else if( id > Command::HashMenu && id < Command::ScriptMenu ) {
-    impl_invoke::invokeHash(id, selection);
+    impl_invoke::invokeHash(id, selection.paths(), snapshot());
   } else if( id == Command::Rename ) {
-    impl_invoke::invokeRename(selection);
+    impl_invoke::invokeRename(selection.paths(), snapshot());
   } else if( id > Command::ScriptMenu ) {
-    impl_invoke::invokeScript(script, selection);
+    impl_invoke::invokeScript(script, selection.paths(), snapshot());
   }
 }
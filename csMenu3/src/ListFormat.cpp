@@ -0,0 +1,517 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <string_view>
+
+#include "ListFormat.h"
+
+#include "Util.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_listformat {
+
+  constexpr std::size_t NPOS = std::wstring::npos;
+  constexpr std::size_t ONE  = 1;
+
+  constexpr wchar_t SEP_NATIVE = L'\\';
+  constexpr wchar_t SEP_UNIX   = L'/';
+  constexpr wchar_t TAB        = L'\t';
+
+  template <bool IS_UNIX>
+  inline wchar_t *write(wchar_t *dest, const wchar_t *first, const std::size_t count)
+  {
+    if constexpr( IS_UNIX ) {
+      return std::replace_copy(first, first + count, dest, SEP_NATIVE, SEP_UNIX);
+    } else {
+      return std::copy_n(first, count, dest);
+    }
+  }
+
+  // Length of the formatted filename, w/o directory separator & EOL.
+  template <Command CMD>
+  inline std::size_t length(const std::wstring& filename)
+  {
+    const std::size_t pos = filename.rfind(SEP_NATIVE);
+
+    if constexpr( CMD == Command::List ) {
+      return pos != NPOS
+             ? filename.size() - pos - ONE
+             : filename.size();
+    } else if constexpr( CMD == Command::ListPathTabular ) {
+      return pos != NPOS
+             ? filename.size() + ONE
+             : filename.size();
+    } else { // Command::ListPath  AKA  "as-is"
+      return filename.size();
+    }
+  }
+
+  template <Command CMD, bool IS_UNIX>
+  inline wchar_t *write(wchar_t *dest, const std::wstring& filename)
+  {
+    const std::size_t pos = filename.rfind(SEP_NATIVE);
+
+    if constexpr( CMD == Command::List ) {
+      if( pos != NPOS ) {
+        return write<IS_UNIX>(dest, filename.data() + pos + ONE, filename.size() - pos - ONE);
+      }
+    } else if constexpr( CMD == Command::ListPathTabular ) {
+      if( pos != NPOS ) {
+        dest    = write<IS_UNIX>(dest, filename.data(), pos + ONE);
+        *dest++ = TAB;
+        return write<IS_UNIX>(dest, filename.data() + pos + ONE, filename.size() - pos - ONE);
+      }
+    }
+
+    return write<IS_UNIX>(dest, filename.data(), filename.size());
+  }
+
+  template <Command CMD, bool IS_UNIX>
+  std::wstring format(const ListItems& items)
+  {
+    const bool is_eol = items.size() != ONE;
+
+    // (1) Exact Size ////////////////////////////////////////////////////////
+
+    std::size_t size = 0;
+    for( const ListItem& item : items ) {
+      if( item.filename.empty() ) {
+        continue;
+      }
+
+      size += length<CMD>(item.filename);
+      size += item.is_directory ? ONE : 0;
+      size += is_eol ? EOL.size() : 0;
+    }
+
+    // (2) Single Pass ///////////////////////////////////////////////////////
+
+    std::wstring text(size, L'\0');
+
+    wchar_t *dest = text.data();
+    for( const ListItem& item : items ) {
+      if( item.filename.empty() ) {
+        continue;
+      }
+
+      dest = write<CMD, IS_UNIX>(dest, item.filename);
+
+      if( item.is_directory ) {
+        *dest++ = IS_UNIX ? SEP_UNIX : SEP_NATIVE;
+      }
+
+      if( is_eol ) {
+        dest = std::copy(EOL.begin(), EOL.end(), dest);
+      }
+    }
+
+    return text;
+  }
+
+  template <Command CMD>
+  inline std::wstring format(const ListItems& items, const bool is_unix)
+  {
+    return is_unix
+           ? format<CMD, true>(items)
+           : format<CMD, false>(items);
+  }
+
+  // Detailed Listing ////////////////////////////////////////////////////////
+
+  /*
+   * NOTE: Each record is emitted twice through the same code: Once into a
+   *       Counter to obtain the exact size, then into a Writer. Hence, both
+   *       passes can never disagree.
+   */
+
+  struct Counter {
+    inline void put(const wchar_t)
+    {
+      size++;
+    }
+
+    inline void put(const std::wstring_view& str)
+    {
+      size += str.size();
+    }
+
+    std::size_t size{0};
+  };
+
+  struct Writer {
+    inline void put(const wchar_t ch)
+    {
+      *dest++ = ch;
+    }
+
+    inline void put(const std::wstring_view& str)
+    {
+      dest = std::copy(str.begin(), str.end(), dest);
+    }
+
+    wchar_t *dest{nullptr};
+  };
+
+  struct AttributeLetter {
+    uint32_t mask{0};
+    wchar_t letter{0};
+  };
+
+  constexpr AttributeLetter ATTRIBUTE_LETTERS[] = {
+    {fileinfo::ReadOnly, L'R'},
+    {fileinfo::Hidden, L'H'},
+    {fileinfo::System, L'S'},
+    {fileinfo::Archive, L'A'},
+    {fileinfo::Compressed, L'C'},
+    {fileinfo::Encrypted, L'E'},
+    {fileinfo::Offline, L'O'},
+    {fileinfo::ReparsePoint, L'L'}};
+
+  // cf. https://howardhinnant.github.io/date_algorithms.html#civil_from_days
+  inline void civilFromDays(int64_t days, int64_t& y, unsigned& m, unsigned& d)
+  {
+    days += 719468;
+    const int64_t era  = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+    d                  = doy - (153 * mp + 2) / 5 + 1;
+    m                  = mp < 10 ? mp + 3 : mp - 9;
+    y                  = static_cast<int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+  }
+
+  template <typename SinkT>
+  inline void putDigits(SinkT& sink, uint64_t value, const std::size_t width)
+  {
+    wchar_t buffer[20];
+    for( std::size_t i = width; i > 0; i-- ) {
+      buffer[i - 1] = static_cast<wchar_t>(L'0' + value % 10);
+      value /= 10;
+    }
+    sink.put(std::wstring_view(buffer, width));
+  }
+
+  template <typename SinkT>
+  inline void putNumber(SinkT& sink, const uint64_t value)
+  {
+    std::size_t width = 1;
+    for( uint64_t v = value; v >= 10; v /= 10 ) {
+      width++;
+    }
+    putDigits(sink, value, width);
+  }
+
+  // Counting fixed-width fields requires no formatting...
+  inline void putDigits(Counter& counter, const uint64_t, const std::size_t width)
+  {
+    counter.size += width;
+  }
+
+  constexpr std::size_t TIME_LENGTH = 20;
+
+  inline void putTime(Counter& counter, const uint64_t)
+  {
+    counter.size += TIME_LENGTH;
+  }
+
+  // "YYYY-MM-DDThh:mm:ssZ", i.e. TIME_LENGTH characters
+  template <typename SinkT>
+  inline void putTime(SinkT& sink, const uint64_t filetime)
+  {
+    constexpr int64_t TICKS_PER_SECOND = 10000000;
+    constexpr int64_t EPOCH_DELTA      = 11644473600; // 1601-01-01 -> 1970-01-01 [s]
+    constexpr int64_t SECONDS_PER_DAY  = 86400;
+
+    const int64_t secs = static_cast<int64_t>(filetime / TICKS_PER_SECOND) - EPOCH_DELTA;
+    int64_t days       = secs / SECONDS_PER_DAY;
+    int64_t tod        = secs % SECONDS_PER_DAY;
+    if( tod < 0 ) {
+      tod += SECONDS_PER_DAY;
+      days--;
+    }
+
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+
+    putDigits(sink, static_cast<uint64_t>(y), 4);
+    sink.put(L'-');
+    putDigits(sink, m, 2);
+    sink.put(L'-');
+    putDigits(sink, d, 2);
+    sink.put(L'T');
+    putDigits(sink, static_cast<uint64_t>(tod / 3600), 2);
+    sink.put(L':');
+    putDigits(sink, static_cast<uint64_t>(tod / 60 % 60), 2);
+    sink.put(L':');
+    putDigits(sink, static_cast<uint64_t>(tod % 60), 2);
+    sink.put(L'Z');
+  }
+
+  template <Command CMD, bool IS_UNIX>
+  inline bool isSpecial(const wchar_t ch)
+  {
+    if constexpr( CMD == Command::ListDetailedCsv ) {
+      return (IS_UNIX && ch == SEP_NATIVE) || ch == L'"';
+    } else if constexpr( CMD == Command::ListDetailedJson ) {
+      return ch == SEP_NATIVE || ch == L'"' || ch < 0x20;
+    } else {
+      return IS_UNIX && ch == SEP_NATIVE;
+    }
+  }
+
+  template <Command CMD, bool IS_UNIX, typename SinkT>
+  inline void putSpecial(SinkT& sink, const wchar_t ch)
+  {
+    constexpr std::wstring_view HEX(L"0123456789abcdef");
+
+    if( IS_UNIX && ch == SEP_NATIVE ) {
+      sink.put(SEP_UNIX);
+    } else if( CMD == Command::ListDetailedCsv ) { // '"'
+      sink.put(L'"');
+      sink.put(L'"');
+    } else if( ch == L'"' || ch == SEP_NATIVE ) { // JSON
+      sink.put(L'\\');
+      sink.put(ch);
+    } else { // JSON: Control Character
+      sink.put(std::wstring_view(L"\\u00"));
+      sink.put(HEX[(ch >> 4) & 0xF]);
+      sink.put(HEX[ch & 0xF]);
+    }
+  }
+
+  template <Command CMD, bool IS_UNIX, typename SinkT>
+  inline void putPath(SinkT& sink, const std::wstring& filename)
+  {
+    if constexpr( CMD != Command::ListDetailedTsv ) {
+      sink.put(L'"');
+    }
+
+    // Copy runs of regular characters in one go...
+    const wchar_t *first = filename.data();
+    const wchar_t *last  = first + filename.size();
+    while( first != last ) {
+      const wchar_t *special = std::find_if(first, last, isSpecial<CMD, IS_UNIX>);
+      sink.put(std::wstring_view(first, special - first));
+      if( special == last ) {
+        break;
+      }
+
+      putSpecial<CMD, IS_UNIX>(sink, *special);
+      first = special + 1;
+    }
+
+    if constexpr( CMD != Command::ListDetailedTsv ) {
+      sink.put(L'"');
+    }
+  }
+
+  template <Command CMD, typename SinkT>
+  inline void putTimeField(SinkT& sink, const uint64_t filetime)
+  {
+    if constexpr( CMD == Command::ListDetailedJson ) {
+      if( filetime == 0 ) {
+        sink.put(std::wstring_view(L"null"));
+        return;
+      }
+
+      sink.put(L'"');
+      putTime(sink, filetime);
+      sink.put(L'"');
+    } else {
+      if( filetime != 0 ) {
+        putTime(sink, filetime);
+      }
+    }
+  }
+
+  template <Command CMD, typename SinkT>
+  inline void putAttributes(SinkT& sink, const uint32_t attributes)
+  {
+    if constexpr( CMD == Command::ListDetailedJson ) {
+      sink.put(L'"');
+    }
+
+    for( const AttributeLetter& attr : ATTRIBUTE_LETTERS ) {
+      if( (attributes & attr.mask) != 0 ) {
+        sink.put(attr.letter);
+      }
+    }
+
+    if constexpr( CMD == Command::ListDetailedJson ) {
+      sink.put(L'"');
+    }
+  }
+
+  template <Command CMD, typename SinkT>
+  inline void putHeader(SinkT& sink)
+  {
+    if constexpr( CMD == Command::ListDetailedCsv ) {
+      sink.put(std::wstring_view(L"path,type,size,created,modified,attributes"));
+    } else if constexpr( CMD == Command::ListDetailedTsv ) {
+      sink.put(std::wstring_view(L"path\ttype\tsize\tcreated\tmodified\tattributes"));
+    } else {
+      sink.put(L'[');
+    }
+    sink.put(EOL);
+  }
+
+  template <Command CMD, typename SinkT>
+  inline void putFooter(SinkT& sink)
+  {
+    if constexpr( CMD == Command::ListDetailedJson ) {
+      sink.put(L']');
+      sink.put(EOL);
+    }
+  }
+
+  template <Command CMD, bool IS_UNIX, typename SinkT>
+  void putRecord(SinkT& sink, const ListItem& item, const bool is_last)
+  {
+    constexpr wchar_t SEP = CMD == Command::ListDetailedTsv
+                            ? TAB
+                            : L',';
+
+    const std::wstring_view type = item.is_directory
+                                   ? L"directory"
+                                   : L"file";
+
+    if constexpr( CMD == Command::ListDetailedJson ) {
+      sink.put(std::wstring_view(L"  {\"path\":"));
+      putPath<CMD, IS_UNIX>(sink, item.filename);
+      sink.put(std::wstring_view(L",\"type\":\""));
+      sink.put(type);
+      sink.put(std::wstring_view(L"\",\"size\":"));
+      putNumber(sink, item.info.size);
+      sink.put(std::wstring_view(L",\"created\":"));
+      putTimeField<CMD>(sink, item.info.ctime);
+      sink.put(std::wstring_view(L",\"modified\":"));
+      putTimeField<CMD>(sink, item.info.mtime);
+      sink.put(std::wstring_view(L",\"attributes\":"));
+      putAttributes<CMD>(sink, item.info.attributes);
+      sink.put(L'}');
+      if( !is_last ) {
+        sink.put(L',');
+      }
+    } else {
+      putPath<CMD, IS_UNIX>(sink, item.filename);
+      sink.put(SEP);
+      sink.put(type);
+      sink.put(SEP);
+      putNumber(sink, item.info.size);
+      sink.put(SEP);
+      putTimeField<CMD>(sink, item.info.ctime);
+      sink.put(SEP);
+      putTimeField<CMD>(sink, item.info.mtime);
+      sink.put(SEP);
+      putAttributes<CMD>(sink, item.info.attributes);
+    }
+    sink.put(EOL);
+  }
+
+  template <Command CMD, bool IS_UNIX, typename SinkT>
+  void putDetailed(SinkT& sink, const ListItems& items)
+  {
+    // NOTE: Skipped (i.e. empty) items must not break JSON's separators!
+    std::size_t last = items.size();
+    for( std::size_t i = 0; i < items.size(); i++ ) {
+      if( !items[i].filename.empty() ) {
+        last = i;
+      }
+    }
+
+    putHeader<CMD>(sink);
+    for( std::size_t i = 0; i < items.size(); i++ ) {
+      if( items[i].filename.empty() ) {
+        continue;
+      }
+
+      putRecord<CMD, IS_UNIX>(sink, items[i], i == last);
+    }
+    putFooter<CMD>(sink);
+  }
+
+  template <Command CMD, bool IS_UNIX>
+  std::wstring formatDetailed(const ListItems& items)
+  {
+    // (1) Exact Size ////////////////////////////////////////////////////////
+
+    Counter counter;
+    putDetailed<CMD, IS_UNIX>(counter, items);
+
+    // (2) Single Pass ///////////////////////////////////////////////////////
+
+    std::wstring text(counter.size, L'\0');
+
+    Writer writer{text.data()};
+    putDetailed<CMD, IS_UNIX>(writer, items);
+
+    return text;
+  }
+
+  template <Command CMD>
+  inline std::wstring formatDetailed(const ListItems& items, const bool is_unix)
+  {
+    return is_unix
+           ? formatDetailed<CMD, true>(items)
+           : formatDetailed<CMD, false>(items);
+  }
+
+} // namespace impl_listformat
+
+////// Public ////////////////////////////////////////////////////////////////
+
+std::wstring formatList(const CommandId id, const ListItems& items, const bool is_unix)
+{
+  using namespace impl_listformat;
+
+  try {
+    if( id == Command::List ) {
+      return format<Command::List>(items, is_unix);
+    } else if( id == Command::ListPath || id == Command::ListCanonical || id == Command::ListTree ) {
+      return format<Command::ListPath>(items, is_unix);
+    } else if( id == Command::ListPathTabular ) {
+      return format<Command::ListPathTabular>(items, is_unix);
+    } else if( id == Command::ListDetailedCsv ) {
+      return formatDetailed<Command::ListDetailedCsv>(items, is_unix);
+    } else if( id == Command::ListDetailedTsv ) {
+      return formatDetailed<Command::ListDetailedTsv>(items, is_unix);
+    } else if( id == Command::ListDetailedJson ) {
+      return formatDetailed<Command::ListDetailedJson>(items, is_unix);
+    }
+  } catch( ... ) {
+  }
+
+  return std::wstring{};
+}
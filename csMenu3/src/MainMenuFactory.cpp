@@ -53,6 +53,11 @@ namespace impl_menu {
     menu->append(winrt::make<CommandInvoke>(Command::List));
     menu->append(winrt::make<CommandInvoke>(Command::ListPath));
     menu->append(winrt::make<CommandInvoke>(Command::ListPathTabular));
+    menu->append(winrt::make<CommandInvoke>(Command::ListCanonical));
+    menu->append(winrt::make<CommandInvoke>(Command::ListDetailedCsv));
+    menu->append(winrt::make<CommandInvoke>(Command::ListDetailedTsv));
+    menu->append(winrt::make<CommandInvoke>(Command::ListDetailedJson));
+    menu->append(winrt::make<CommandInvoke>(Command::ListTree));
 
     // Rename ////////////////////////////////////////////////////////////////
 
@@ -69,6 +74,9 @@ namespace impl_menu {
     menu->append(winrt::make<CommandFlag>(flags.testAny(MenuFlag::ParallelExecution), Command::CheckParallelExecution));
     menu->append(winrt::make<CommandFlag>(flags.testAny(MenuFlag::ResolveUncPaths), Command::CheckResolveUncPaths));
     menu->append(winrt::make<CommandFlag>(flags.testAny(MenuFlag::UnixPathSeparators), Command::CheckUnixPathSeparators));
+    menu->append(winrt::make<CommandFlag>(flags.testAny(MenuFlag::HashSidecarFiles), Command::CheckHashSidecarFiles));
+
+    menu->append(winrt::make<CommandInvoke>(Command::CalibrateStorage));
   }
 
 } // namespace impl_menu
@@ -0,0 +1,364 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <deque>
+
+#include "MultiReplace.h"
+
+#include "Win32/String.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_multireplace {
+
+  constexpr std::size_t NPOS = std::wstring_view::npos;
+
+  constexpr uint32_t MAX_STATES = 64 * 1024;
+  constexpr uint32_t NONE       = UINT32_MAX;
+  constexpr uint32_t ROOT       = 0;
+
+  constexpr std::size_t NUM_ASCII = 0x80;
+
+  std::vector<std::wstring_view> split(const std::wstring_view& text)
+  {
+    std::vector<std::wstring_view> result;
+
+    std::size_t last = 0;
+    for( std::size_t pos = text.find(MultiReplace::SEPARATOR); pos != NPOS;
+         pos = text.find(MultiReplace::SEPARATOR, last) ) {
+      result.push_back(text.substr(last, pos - last));
+      last = pos + 1;
+    }
+    result.push_back(text.substr(last));
+
+    return result;
+  }
+
+  // Returns the bitwise OR of all characters of src.
+  uint32_t foldAscii(wchar_t *dst, const wchar_t *src, const std::size_t length)
+  {
+    uint32_t any = 0;
+    for( std::size_t i = 0; i < length; i++ ) {
+      const uint32_t ch = static_cast<uint32_t>(src[i]);
+      dst[i] = static_cast<wchar_t>(ch + (ch - L'A' < 26 ? 0x20 : 0));
+      any |= ch;
+    }
+
+    return any;
+  }
+
+  /*
+   * NOTE: ASCII is folded without branches, i.e. the loop is vectorized by
+   *       the compiler. Text with non-ASCII characters is then upper-cased
+   *       by the OS in one call & its ASCII folded to lower case again; e.g.
+   *       "ä" folds to "Ä", but "ſ" to "s". Cf. Regex's fold().
+   */
+
+  void foldCase(std::wstring& result, const std::wstring_view& text)
+  {
+    result.resize(text.size());
+
+    const wchar_t *src = text.data();
+    wchar_t       *dst = result.data();
+
+    if( foldAscii(dst, src, text.size()) < NUM_ASCII ) {
+      return;
+    }
+
+    if( !StringToUpper(dst, src, text.size()) ) {
+      foldAscii(dst, src, text.size()); // Fold ASCII, at least...
+      return;
+    }
+
+    foldAscii(dst, dst, text.size());
+  }
+
+} // namespace impl_multireplace
+
+////// public ////////////////////////////////////////////////////////////////
+
+MultiReplace::MultiReplace() noexcept
+{
+}
+
+MultiReplace::MultiReplace(const std::wstring_view& patterns,
+                           const std::wstring_view& replaces) noexcept
+{
+  using namespace impl_multireplace;
+
+  constexpr std::wstring_view FLAG_IGNORE_CASE(L"(?i)");
+
+  try {
+    std::wstring_view list = patterns;
+    if( list.starts_with(FLAG_IGNORE_CASE) ) {
+      _isCaseInsensitive = true;
+      list.remove_prefix(FLAG_IGNORE_CASE.size());
+    }
+
+    // (1) Pair patterns & replacements //////////////////////////////////////
+
+    const std::vector<std::wstring_view> allPatterns = split(list);
+    const std::vector<std::wstring_view> allReplaces = split(replaces);
+    if( allReplaces.size() != 1 && allReplaces.size() != allPatterns.size() ) {
+      return;
+    }
+
+    std::vector<std::wstring_view> keys;
+    for( std::size_t i = 0; i < allPatterns.size(); i++ ) {
+      if( allPatterns[i].empty() ) {
+        continue;
+      }
+
+      keys.push_back(allPatterns[i]);
+      _lengths.push_back(allPatterns[i].size());
+      _replaces.emplace_back(allReplaces[allReplaces.size() == 1 ? 0 : i]);
+    }
+
+    // (2) Build automaton ///////////////////////////////////////////////////
+
+    if( keys.empty() || !compile(keys) ) {
+      _delta.clear();
+    }
+  } catch( ... ) {
+    _delta.clear();
+  }
+}
+
+MultiReplace::~MultiReplace() noexcept
+{
+}
+
+bool MultiReplace::isValid() const
+{
+  return !_delta.empty();
+}
+
+std::size_t MultiReplace::numPatterns() const
+{
+  return isValid()
+         ? _lengths.size()
+         : 0;
+}
+
+bool MultiReplace::replaceAll(std::wstring& result, const std::wstring_view& input) const
+{
+  using namespace impl_multireplace;
+
+  if( !isValid() ) {
+    return false;
+  }
+
+  std::wstring_view text = input;
+  if( _isCaseInsensitive ) {
+    foldCase(_folded, input);
+    text = _folded;
+  }
+
+  /*
+   * NOTE: A match ending at pos is only a candidate; a match found later
+   *       might start further left, or at the same position but be longer.
+   *       Once the current state, i.e. the longest suffix of the text that
+   *       is a prefix of any pattern, starts after the candidate, it wins.
+   *       Scanning resumes after the winner.
+   */
+
+  std::size_t last      = 0;
+  std::size_t pos       = 0;
+  uint32_t    state     = ROOT;
+  std::size_t candFirst = NPOS;
+  uint32_t    candIndex = NONE;
+
+  const auto lambda_commit = [&]() -> void {
+    result.append(input.substr(last, candFirst - last));
+    result.append(_replaces[candIndex]);
+
+    last      = candFirst + _lengths[candIndex];
+    pos       = last;
+    state     = ROOT;
+    candFirst = NPOS;
+    candIndex = NONE;
+  };
+
+  while( true ) {
+    if( pos >= text.size() ) {
+      if( candFirst == NPOS ) {
+        break;
+      }
+      lambda_commit();
+      continue;
+    }
+
+    state = _delta[state*_numClasses + classOf(text[pos])];
+    pos++;
+
+    const uint32_t match = _match[state];
+    if( match != NONE ) {
+      const std::size_t first = pos - _lengths[match];
+      if( first <= candFirst ) { // NOTE: NPOS is the maximum
+        candFirst = first;
+        candIndex = match;
+      }
+    }
+
+    if( candFirst != NPOS && pos - _depth[state] > candFirst ) {
+      lambda_commit();
+    }
+  }
+
+  result.append(input.substr(last));
+
+  return true;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool MultiReplace::compile(const std::vector<std::wstring_view>& patterns)
+{
+  using namespace impl_multireplace;
+
+  // (1) Fold patterns ///////////////////////////////////////////////////////
+
+  std::vector<std::wstring> keys(patterns.size());
+  for( std::size_t i = 0; i < patterns.size(); i++ ) {
+    if( _isCaseInsensitive ) {
+      foldCase(keys[i], patterns[i]);
+    } else {
+      keys[i].assign(patterns[i]);
+    }
+  }
+
+  // (2) Assign character classes ////////////////////////////////////////////
+
+  _asciiClasses.assign(NUM_ASCII, 0);
+  _otherClasses.clear();
+  _numClasses = 1;
+
+  for( const std::wstring& key : keys ) {
+    for( const wchar_t ch : key ) {
+      if( classOf(ch) != 0 ) {
+        continue;
+      }
+
+      const uint32_t id = static_cast<uint32_t>(_numClasses++);
+      if( static_cast<uint32_t>(ch) < NUM_ASCII ) {
+        _asciiClasses[static_cast<std::size_t>(ch)] = id;
+      } else {
+        const CharClass cc{ch, id};
+        _otherClasses.insert(std::upper_bound(_otherClasses.begin(), _otherClasses.end(), cc,
+                                              [](const CharClass& a, const CharClass& b) -> bool {
+                                                return a.ch < b.ch;
+                                              }), cc);
+      }
+    }
+  }
+
+  // (3) Build trie //////////////////////////////////////////////////////////
+
+  const auto lambda_add = [&](const uint32_t depth) -> uint32_t {
+    _delta.resize(_delta.size() + _numClasses, NONE);
+    _depth.push_back(depth);
+    _match.push_back(NONE);
+    return static_cast<uint32_t>(_depth.size() - 1);
+  };
+
+  _delta.clear();
+  _depth.clear();
+  _match.clear();
+  lambda_add(0);
+
+  for( std::size_t i = 0; i < keys.size(); i++ ) {
+    uint32_t state = ROOT;
+    for( const wchar_t ch : keys[i] ) {
+      const std::size_t index = state*_numClasses + classOf(ch);
+      if( _delta[index] == NONE ) {
+        if( _depth.size() >= MAX_STATES ) {
+          return false;
+        }
+        const uint32_t next = lambda_add(_depth[state] + 1);
+        _delta[index] = next;
+      }
+      state = _delta[index];
+    }
+
+    if( _match[state] == NONE ) { // The first of duplicate patterns wins
+      _match[state] = static_cast<uint32_t>(i);
+    }
+  }
+
+  // (4) Resolve failure links into transitions; breadth first ///////////////
+
+  std::vector<uint32_t> fail(_depth.size(), ROOT);
+
+  std::deque<uint32_t> queue;
+  queue.push_back(ROOT);
+  while( !queue.empty() ) {
+    const uint32_t state = queue.front();
+    queue.pop_front();
+
+    for( std::size_t c = 0; c < _numClasses; c++ ) {
+      uint32_t& next = _delta[state*_numClasses + c];
+
+      if( next == NONE ) {
+        next = state == ROOT
+               ? ROOT
+               : _delta[fail[state]*_numClasses + c];
+        continue;
+      }
+
+      fail[next] = state == ROOT
+                   ? ROOT
+                   : _delta[fail[state]*_numClasses + c];
+      if( _match[next] == NONE ) { // Longest pattern that is a proper suffix
+        _match[next] = _match[fail[next]];
+      }
+
+      queue.push_back(next);
+    }
+  }
+
+  return true;
+}
+
+uint32_t MultiReplace::classOf(const wchar_t ch) const
+{
+  if( static_cast<uint32_t>(ch) < impl_multireplace::NUM_ASCII ) {
+    return _asciiClasses[static_cast<std::size_t>(ch)];
+  }
+
+  const auto iter = std::lower_bound(_otherClasses.begin(), _otherClasses.end(), ch,
+                                     [](const CharClass& cc, const wchar_t value) -> bool {
+                                       return cc.ch < value;
+                                     });
+  return iter != _otherClasses.end() && iter->ch == ch
+         ? iter->id
+         : 0;
+}
@@ -0,0 +1,852 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "Regex.h"
+
+#include "Win32/String.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_regex {
+
+  constexpr uint32_t MAX_INSTS  = 64 * 1024;
+  constexpr uint32_t MAX_REPEAT = 1000;
+  constexpr uint32_t INFINITE   = UINT32_MAX;
+
+  inline bool isDigit(const wchar_t ch)
+  {
+    return ch >= L'0' && ch <= L'9';
+  }
+
+  inline bool isAlnum(const wchar_t ch)
+  {
+    return isDigit(ch) || (ch >= L'A' && ch <= L'Z') || (ch >= L'a' && ch <= L'z');
+  }
+
+  // NOTE: The C runtime's "C" locale maps ASCII only; e.g. "ä" -> "Ä" needs the OS.
+
+  inline wchar_t upper(const wchar_t ch)
+  {
+    if( ch >= L'a' && ch <= L'z' ) {
+      return ch - L'a' + L'A';
+    } else if( ch < 0x80 ) {
+      return ch;
+    }
+
+    wchar_t result;
+    return StringToUpper(&result, &ch, 1)
+           ? result
+           : ch;
+  }
+
+  inline wchar_t lower(const wchar_t ch)
+  {
+    if( ch >= L'A' && ch <= L'Z' ) {
+      return ch - L'A' + L'a';
+    } else if( ch < 0x80 ) {
+      return ch;
+    }
+
+    wchar_t result;
+    return StringToLower(&result, &ch, 1)
+           ? result
+           : ch;
+  }
+
+  // Case-insensitive identity; ASCII is folded to lower case, all other
+  // characters to upper case, as is MultiReplace's foldCase().
+  inline wchar_t fold(const wchar_t ch)
+  {
+    if( ch < 0x80 ) {
+      return lower(ch);
+    }
+
+    const wchar_t up = upper(ch);
+    return up < 0x80
+           ? lower(up)
+           : up;
+  }
+
+  struct Node {
+    enum Type : unsigned {
+      Empty = 0,
+      Literal,
+      Any,
+      Class,
+      Begin,
+      End,
+      Group,
+      Concat,
+      Alternate,
+      Repeat
+    };
+
+    Type type{Empty};
+    uint32_t value{0}; // Literal: character; Class, Group: index
+    uint32_t min{0};
+    uint32_t max{0};
+    bool isGreedy{true};
+    std::vector<Node> children{};
+  };
+
+} // namespace impl_regex
+
+// Parser ////////////////////////////////////////////////////////////////////
+
+class Regex::Parser {
+public:
+  Parser(Regex& regex, const std::wstring_view& pattern) noexcept
+    : _regex{regex}
+    , _pattern{pattern}
+  {
+  }
+
+  ~Parser() noexcept
+  {
+  }
+
+  bool parse()
+  {
+    using Node = impl_regex::Node;
+
+    constexpr std::wstring_view FLAG_IGNORE_CASE(L"(?i)");
+
+    if( _pattern.substr(0, FLAG_IGNORE_CASE.size()) == FLAG_IGNORE_CASE ) {
+      _regex._isCaseInsensitive = true;
+      _pos                      = FLAG_IGNORE_CASE.size();
+    }
+
+    _regex._numGroups = 1;
+
+    Node root;
+    if( !parseAlternate(root) || !atEnd() ) {
+      return false;
+    }
+
+    emitInst(Op::Save, 0);
+    if( !emit(root) ) {
+      return false;
+    }
+    emitInst(Op::Save, 1);
+    emitInst(Op::Match);
+
+    return _regex._program.size() <= impl_regex::MAX_INSTS;
+  }
+
+private:
+  using Node = impl_regex::Node;
+
+  Parser() noexcept = delete;
+
+  // Input ///////////////////////////////////////////////////////////////////
+
+  bool accept(const wchar_t ch)
+  {
+    if( atEnd() || _pattern[_pos] != ch ) {
+      return false;
+    }
+    _pos++;
+    return true;
+  }
+
+  bool atEnd() const
+  {
+    return _pos >= _pattern.size();
+  }
+
+  wchar_t peek() const
+  {
+    return _pattern[_pos];
+  }
+
+  bool parseNumber(uint32_t& number)
+  {
+    if( atEnd() || !impl_regex::isDigit(peek()) ) {
+      return false;
+    }
+
+    number = 0;
+    while( !atEnd() && impl_regex::isDigit(peek()) ) {
+      number = number*10 + static_cast<uint32_t>(peek() - L'0');
+      if( number > impl_regex::MAX_REPEAT ) {
+        return false;
+      }
+      _pos++;
+    }
+
+    return true;
+  }
+
+  // Syntax //////////////////////////////////////////////////////////////////
+
+  bool parseAlternate(Node& node)
+  {
+    Node first;
+    if( !parseConcat(first) ) {
+      return false;
+    }
+
+    if( atEnd() || peek() != L'|' ) {
+      node = std::move(first);
+      return true;
+    }
+
+    node.type = Node::Alternate;
+    node.children.push_back(std::move(first));
+    while( accept(L'|') ) {
+      Node next;
+      if( !parseConcat(next) ) {
+        return false;
+      }
+      node.children.push_back(std::move(next));
+    }
+
+    return true;
+  }
+
+  bool parseConcat(Node& node)
+  {
+    node.type = Node::Concat;
+    while( !atEnd() && peek() != L'|' && peek() != L')' ) {
+      Node next;
+      if( !parseRepeat(next) ) {
+        return false;
+      }
+      node.children.push_back(std::move(next));
+    }
+
+    return true;
+  }
+
+  bool parseRepeat(Node& node)
+  {
+    Node atom;
+    if( !parseAtom(atom) ) {
+      return false;
+    }
+
+    uint32_t min = 0;
+    uint32_t max = 0;
+    if( accept(L'*') ) {
+      max = impl_regex::INFINITE;
+    } else if( accept(L'+') ) {
+      min = 1;
+      max = impl_regex::INFINITE;
+    } else if( accept(L'?') ) {
+      max = 1;
+    } else if( accept(L'{') ) {
+      if( !parseNumber(min) ) {
+        return false;
+      }
+      max = min;
+      if( accept(L',') ) {
+        max = impl_regex::INFINITE;
+        if( !atEnd() && peek() != L'}' && (!parseNumber(max) || max < min) ) {
+          return false;
+        }
+      }
+      if( !accept(L'}') ) {
+        return false;
+      }
+    } else {
+      node = std::move(atom);
+      return true;
+    }
+
+    node.type     = Node::Repeat;
+    node.min      = min;
+    node.max      = max;
+    node.isGreedy = !accept(L'?');
+    node.children.push_back(std::move(atom));
+
+    return true;
+  }
+
+  bool parseAtom(Node& node)
+  {
+    const wchar_t ch = peek();
+    _pos++;
+
+    if( ch == L'(' ) {
+      if( accept(L'?') ) {
+        if( !accept(L':') ) {
+          return false;
+        }
+        return parseAlternate(node) && accept(L')');
+      }
+
+      node.type  = Node::Group;
+      node.value = static_cast<uint32_t>(_regex._numGroups++);
+      node.children.emplace_back();
+      return parseAlternate(node.children.back()) && accept(L')');
+
+    } else if( ch == L'[' ) {
+      return parseClass(node);
+
+    } else if( ch == L'\\' ) {
+      if( atEnd() ) {
+        return false;
+      }
+      const wchar_t esc = peek();
+      _pos++;
+
+      CharClass cls;
+      if( addEscapeClass(cls, esc) ) {
+        return makeClass(node, std::move(cls));
+      } else if( impl_regex::isAlnum(esc) ) {
+        return false;
+      }
+      return makeLiteral(node, esc);
+
+    } else if( ch == L'.' ) {
+      node.type = Node::Any;
+    } else if( ch == L'^' ) {
+      node.type = Node::Begin;
+    } else if( ch == L'$' ) {
+      node.type = Node::End;
+    } else if( ch == L'*' || ch == L'+' || ch == L'?' || ch == L'{' ) {
+      return false; // Nothing to repeat
+    } else {
+      return makeLiteral(node, ch);
+    }
+
+    return true;
+  }
+
+  bool parseClass(Node& node)
+  {
+    CharClass cls;
+    cls.isNegated = accept(L'^');
+
+    bool is_first = true;
+    while( !atEnd() && (is_first || peek() != L']') ) {
+      is_first = false;
+
+      wchar_t first = peek();
+      _pos++;
+
+      if( first == L'\\' ) {
+        if( atEnd() ) {
+          return false;
+        }
+        const wchar_t esc = peek();
+        _pos++;
+
+        if( esc == L'd' || esc == L's' || esc == L'w' ) {
+          addEscapeClass(cls, esc);
+          continue;
+        } else if( impl_regex::isAlnum(esc) ) {
+          return false;
+        }
+        first = esc;
+      }
+
+      wchar_t last = first;
+      if( _pos + 1 < _pattern.size() && peek() == L'-' && _pattern[_pos + 1] != L']' ) {
+        _pos++;
+        last = peek();
+        _pos++;
+
+        if( last == L'\\' ) {
+          if( atEnd() || impl_regex::isAlnum(peek()) ) {
+            return false;
+          }
+          last = peek();
+          _pos++;
+        }
+        if( last < first ) {
+          return false;
+        }
+      }
+
+      cls.ranges.push_back(Range{first, last});
+    }
+
+    if( !accept(L']') ) {
+      return false;
+    }
+
+    return makeClass(node, std::move(cls));
+  }
+
+  // Nodes ///////////////////////////////////////////////////////////////////
+
+  static bool addEscapeClass(CharClass& cls, const wchar_t esc)
+  {
+    const wchar_t lower = impl_regex::fold(esc);
+    if( lower == L'd' ) {
+      cls.ranges.push_back(Range{L'0', L'9'});
+    } else if( lower == L's' ) {
+      cls.ranges.push_back(Range{L'\t', L'\r'});
+      cls.ranges.push_back(Range{L' ', L' '});
+    } else if( lower == L'w' ) {
+      cls.ranges.push_back(Range{L'0', L'9'});
+      cls.ranges.push_back(Range{L'A', L'Z'});
+      cls.ranges.push_back(Range{L'_', L'_'});
+      cls.ranges.push_back(Range{L'a', L'z'});
+    } else {
+      return false;
+    }
+
+    cls.isNegated = esc != lower; // \D, \S, \W
+    return true;
+  }
+
+  bool makeClass(Node& node, CharClass&& cls)
+  {
+    node.type  = Node::Class;
+    node.value = static_cast<uint32_t>(_regex._classes.size());
+    _regex._classes.push_back(std::move(cls));
+    return true;
+  }
+
+  bool makeLiteral(Node& node, const wchar_t ch)
+  {
+    node.type  = Node::Literal;
+    node.value = static_cast<uint32_t>(_regex._isCaseInsensitive
+                                       ? impl_regex::fold(ch)
+                                       : ch);
+    return true;
+  }
+
+  // Code ////////////////////////////////////////////////////////////////////
+
+  bool emit(const Node& node)
+  {
+    if( _regex._program.size() > impl_regex::MAX_INSTS ) {
+      return false;
+    }
+
+    if( node.type == Node::Literal ) {
+      emitInst(Op::Char, node.value);
+    } else if( node.type == Node::Any ) {
+      emitInst(Op::Any);
+    } else if( node.type == Node::Class ) {
+      emitInst(Op::Class, node.value);
+    } else if( node.type == Node::Begin ) {
+      emitInst(Op::Begin);
+    } else if( node.type == Node::End ) {
+      emitInst(Op::End);
+
+    } else if( node.type == Node::Group ) {
+      emitInst(Op::Save, 2*node.value);
+      if( !emit(node.children.front()) ) {
+        return false;
+      }
+      emitInst(Op::Save, 2*node.value + 1);
+
+    } else if( node.type == Node::Concat ) {
+      for( const Node& child : node.children ) {
+        if( !emit(child) ) {
+          return false;
+        }
+      }
+
+    } else if( node.type == Node::Alternate ) {
+      std::vector<uint32_t> jumps;
+      for( std::size_t i = 0; i + 1 < node.children.size(); i++ ) {
+        const uint32_t split = emitInst(Op::Split);
+        _regex._program[split].x = size();
+        if( !emit(node.children[i]) ) {
+          return false;
+        }
+        jumps.push_back(emitInst(Op::Jump));
+        _regex._program[split].y = size();
+      }
+      if( !emit(node.children.back()) ) {
+        return false;
+      }
+      for( const uint32_t jump : jumps ) {
+        _regex._program[jump].x = size();
+      }
+
+    } else if( node.type == Node::Repeat ) {
+      return emitRepeat(node);
+    }
+
+    return true;
+  }
+
+  bool emitRepeat(const Node& node)
+  {
+    const Node& child = node.children.front();
+
+    for( uint32_t i = 0; i < node.min; i++ ) {
+      if( !emit(child) ) {
+        return false;
+      }
+    }
+
+    if( node.max == impl_regex::INFINITE ) {
+      const uint32_t split = emitInst(Op::Split);
+      if( !emit(child) ) {
+        return false;
+      }
+      emitInst(Op::Jump, split);
+      setSplit(split, split + 1, size(), node.isGreedy);
+      return true;
+    }
+
+    std::vector<uint32_t> splits;
+    for( uint32_t i = node.min; i < node.max; i++ ) {
+      splits.push_back(emitInst(Op::Split));
+      if( !emit(child) ) {
+        return false;
+      }
+    }
+    for( const uint32_t split : splits ) {
+      setSplit(split, split + 1, size(), node.isGreedy);
+    }
+
+    return true;
+  }
+
+  uint32_t emitInst(const Op op, const uint32_t x = 0, const uint32_t y = 0)
+  {
+    _regex._program.push_back(Inst{op, x, y});
+    return size() - 1;
+  }
+
+  void setSplit(const uint32_t split, const uint32_t body, const uint32_t out,
+                const bool isGreedy)
+  {
+    Inst& inst = _regex._program[split];
+    inst.x     = isGreedy ? body : out;
+    inst.y     = isGreedy ? out : body;
+  }
+
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>(_regex._program.size());
+  }
+
+  Regex& _regex;
+  std::wstring_view _pattern{};
+  std::size_t _pos{0};
+};
+
+// Threads ///////////////////////////////////////////////////////////////////
+
+void Regex::Threads::clear()
+{
+  size = 0;
+}
+
+void Regex::Threads::resize(const std::size_t numInsts, const std::size_t numSlots)
+{
+  dense.assign(numInsts, 0);
+  sparse.assign(numInsts, 0);
+  slots.assign(numInsts*numSlots, NPOS);
+  size = 0;
+}
+
+////// public ////////////////////////////////////////////////////////////////
+
+Regex::Regex() noexcept
+{
+}
+
+Regex::Regex(const std::wstring_view& pattern,
+             const std::wstring_view& replace) noexcept
+{
+  try {
+    Parser parser(*this, pattern);
+    if( !parser.parse() || !compileReplace(replace) ) {
+      _program.clear();
+      return;
+    }
+
+    // Scratch memory; cf. addThread() & search().
+    const std::size_t numSlots = 2*_numGroups;
+    _captures.assign(numSlots, NPOS);
+    _work.assign(numSlots, NPOS);
+    _stack.reserve(2*_program.size() + 1);
+    _current.resize(_program.size(), numSlots);
+    _next.resize(_program.size(), numSlots);
+  } catch( ... ) {
+    _program.clear();
+  }
+}
+
+Regex::~Regex() noexcept
+{
+}
+
+bool Regex::isValid() const
+{
+  return !_program.empty();
+}
+
+std::size_t Regex::numGroups() const
+{
+  return _numGroups;
+}
+
+bool Regex::search(const std::wstring_view& input, const std::size_t pos) const
+{
+  if( !isValid() || pos > input.size() ) {
+    return false;
+  }
+
+  const std::size_t numSlots = 2*_numGroups;
+
+  // First instruction after Save 0; cf. Parser::parse().
+  const Inst& start = _program[1];
+
+  bool is_matched = false;
+  _current.clear();
+  for( std::size_t at = pos; ; at++ ) {
+    // Skip ahead to the first possible match, if it starts with a literal.
+    if( _current.size == 0 && start.op == Op::Char ) {
+      while( at < input.size() && !isMatch(start, input[at]) ) {
+        at++;
+      }
+      if( at >= input.size() ) {
+        break;
+      }
+    }
+
+    // Start a new thread at each position, with the lowest priority.
+    if( !is_matched && (at == 0 || start.op != Op::Begin) ) {
+      std::fill(_work.begin(), _work.end(), NPOS);
+      addThread(_current, 0, at, input);
+    }
+
+    if( _current.size == 0 ) {
+      break;
+    }
+
+    _next.clear();
+    for( std::size_t i = 0; i < _current.size; i++ ) {
+      const Inst& inst                  = _program[_current.dense[i]];
+      Captures::const_iterator captures = _current.slots.cbegin() + i*numSlots;
+
+      if( inst.op == Op::Match ) {
+        std::copy(captures, captures + numSlots, _captures.begin());
+        is_matched = true;
+        break; // Cut off threads of lower priority
+      }
+
+      if( at < input.size() && isMatch(inst, input[at]) ) {
+        std::copy(captures, captures + numSlots, _work.begin());
+        addThread(_next, _current.dense[i] + 1, at + 1, input);
+      }
+    }
+
+    std::swap(_current, _next);
+
+    if( at >= input.size() ) {
+      break;
+    }
+  }
+
+  return is_matched;
+}
+
+const Regex::Captures& Regex::captures() const
+{
+  return _captures;
+}
+
+bool Regex::replaceAll(std::wstring& result, const std::wstring_view& input) const
+{
+  if( !isValid() ) {
+    return false;
+  }
+
+  std::size_t last = 0;
+  for( std::size_t pos = 0; search(input, pos); ) {
+    const std::size_t first = _captures[0];
+    const std::size_t end   = _captures[1];
+
+    result.append(input.substr(last, first - last));
+    for( const Piece& piece : _replace ) {
+      if( piece.group == NPOS ) {
+        result.append(piece.text);
+      } else if( _captures[2*piece.group] != NPOS ) {
+        const std::size_t begin = _captures[2*piece.group];
+        result.append(input.substr(begin, _captures[2*piece.group + 1] - begin));
+      }
+    }
+
+    last = end;
+    if( end == first ) { // Empty match; advance by one character
+      if( end >= input.size() ) {
+        break;
+      }
+      result.push_back(input[end]);
+      last = end + 1;
+    }
+    pos = last;
+  }
+
+  result.append(input.substr(last));
+
+  return true;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+/*
+ * NOTE: Follows all non-consuming instructions from pc, in order of priority,
+ *       and records the threads waiting on input with a copy of _work.
+ *       Save pushes a frame restoring the previous offset, which is popped
+ *       only after all of its successors have been followed.
+ */
+
+void Regex::addThread(Threads& list, const uint32_t pc, const std::size_t pos,
+                      const std::wstring_view& input) const
+{
+  const std::size_t numSlots = 2*_numGroups;
+
+  _stack.clear();
+  _stack.push_back(Frame{pc});
+  while( !_stack.empty() ) {
+    const Frame frame = _stack.back();
+    _stack.pop_back();
+
+    if( frame.isRestore ) {
+      _work[frame.slot] = frame.value;
+      continue;
+    }
+
+    const uint32_t at = list.sparse[frame.pc];
+    if( at < list.size && list.dense[at] == frame.pc ) {
+      continue; // Already on the list
+    }
+
+    const std::size_t index = list.size++;
+    list.dense[index]       = frame.pc;
+    list.sparse[frame.pc]   = static_cast<uint32_t>(index);
+
+    const Inst& inst = _program[frame.pc];
+    if( inst.op == Op::Jump ) {
+      _stack.push_back(Frame{inst.x});
+    } else if( inst.op == Op::Split ) {
+      _stack.push_back(Frame{inst.y});
+      _stack.push_back(Frame{inst.x});
+    } else if( inst.op == Op::Save ) {
+      _stack.push_back(Frame{0, inst.x, _work[inst.x], true});
+      _work[inst.x] = pos;
+      _stack.push_back(Frame{frame.pc + 1});
+    } else if( inst.op == Op::Begin ) {
+      if( pos == 0 ) {
+        _stack.push_back(Frame{frame.pc + 1});
+      }
+    } else if( inst.op == Op::End ) {
+      if( pos == input.size() ) {
+        _stack.push_back(Frame{frame.pc + 1});
+      }
+    } else {
+      std::copy(_work.cbegin(), _work.cend(), list.slots.begin() + index*numSlots);
+    }
+  }
+}
+
+bool Regex::compileReplace(const std::wstring_view& replace)
+{
+  Piece text;
+  for( std::size_t i = 0; i < replace.size(); i++ ) {
+    if( replace[i] != L'$' ) {
+      text.text.push_back(replace[i]);
+      continue;
+    }
+
+    if( ++i >= replace.size() ) {
+      return false;
+    }
+
+    std::size_t group = 0;
+    if( replace[i] == L'$' ) {
+      text.text.push_back(L'$');
+      continue;
+    } else if( impl_regex::isDigit(replace[i]) ) {
+      group = static_cast<std::size_t>(replace[i] - L'0');
+    } else if( replace[i] == L'{' ) {
+      const std::size_t close = replace.find(L'}', i);
+      if( close == NPOS || close == i + 1 ) {
+        return false;
+      }
+      for( i++; i < close; i++ ) {
+        if( !impl_regex::isDigit(replace[i]) || group >= _numGroups ) {
+          return false;
+        }
+        group = group*10 + static_cast<std::size_t>(replace[i] - L'0');
+      }
+    } else {
+      return false;
+    }
+
+    if( group >= _numGroups ) {
+      return false;
+    }
+
+    if( !text.text.empty() ) {
+      _replace.push_back(std::move(text));
+      text = Piece{};
+    }
+    _replace.push_back(Piece{group});
+  }
+
+  if( !text.text.empty() ) {
+    _replace.push_back(std::move(text));
+  }
+
+  return true;
+}
+
+bool Regex::isMatch(const Inst& inst, const wchar_t ch) const
+{
+  if( inst.op == Op::Char ) {
+    return static_cast<uint32_t>(_isCaseInsensitive ? impl_regex::fold(ch) : ch) == inst.x;
+  } else if( inst.op == Op::Any ) {
+    return true;
+  } else if( inst.op != Op::Class ) {
+    return false;
+  }
+
+  const CharClass& cls = _classes[inst.x];
+
+  const auto contains = [&](const wchar_t c) -> bool {
+    return std::any_of(cls.ranges.cbegin(), cls.ranges.cend(), [c](const Range& r) -> bool {
+      return c >= r.first && c <= r.last;
+    });
+  };
+
+  bool is_member = contains(ch);
+  if( !is_member && _isCaseInsensitive ) {
+    is_member = contains(impl_regex::lower(ch)) || contains(impl_regex::upper(ch));
+  }
+
+  return is_member != cls.isNegated;
+}
@@ -29,46 +29,8 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <utility>
-
-#include <cs/Text/StringUtil.h>
-
 #include "Rename.h"
 
-////// Private ///////////////////////////////////////////////////////////////
-
-namespace fs = std::filesystem;
-
-using FileName = std::pair<std::wstring, std::wstring>;
-
-namespace impl_rename {
-
-  constexpr wchar_t DOT = L'.';
-
-  constexpr std::size_t NPOS = std::wstring::npos;
-  constexpr std::size_t ONE  = 1;
-  constexpr std::size_t ZERO = 0;
-
-  fs::path join(const FileName& filename)
-  {
-    return fs::path(filename.first + DOT + filename.second);
-  }
-
-  FileName split(const fs::path& path)
-  {
-    const std::wstring filename = path.filename().wstring();
-
-    const std::size_t posDot = filename.rfind(DOT);
-    if( posDot == ZERO || posDot == NPOS ) {
-      return FileName(filename, std::wstring());
-    }
-
-    return FileName(filename.substr(ZERO, posDot),
-                    filename.substr(posDot + ONE));
-  }
-
-} // namespace impl_rename
-
 ////// public ////////////////////////////////////////////////////////////////
 
 Rename::Rename(const Mode mode,
@@ -89,48 +51,3 @@ bool Rename::isValid() const
 {
   return mode != Invalid && !pattern.empty();
 }
-
-void Rename::operator()(const std::filesystem::path& oldPath) const
-{
-  // (1) Extract filename & extension to work item ///////////////////////////
-
-  FileName filename = impl_rename::split(oldPath);
-
-  std::wstring item = isExtension
-                      ? filename.second
-                      : filename.first;
-
-  // (2) Rename work item ////////////////////////////////////////////////////
-
-  if( mode == Append ) {
-    item.append(pattern);
-  } else if( mode == Prepend ) {
-    item.insert(impl_rename::ZERO, pattern);
-  } else if( mode == Remove ) {
-    cs::removeAll(item, pattern);
-  } else if( mode == Replace ) {
-    cs::replaceAll(item, pattern, replace);
-  }
-
-  // (3) Re-Build filename & sanity check ////////////////////////////////////
-
-  if( isExtension ) {
-    filename.second = item;
-  } else {
-    filename.first = item;
-  }
-
-  if( filename.first.empty() ) {
-    return;
-  }
-
-  // (4) Execute rename //////////////////////////////////////////////////////
-
-  const fs::path newPath = oldPath.parent_path() / impl_rename::join(filename);
-  if( newPath == oldPath ) {
-    return;
-  }
-
-  std::error_code ec;
-  fs::rename(oldPath, newPath, ec);
-}
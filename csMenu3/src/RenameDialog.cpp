@@ -29,51 +29,163 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <format>
+
 #define UNICODE
 #include <Windows.h>
+#include <CommCtrl.h>
 
 #include "Win32/UI/CheckBox.h"
 #include "Win32/UI/ComboBox.h"
 #include "Win32/UI/EditText.h"
+#include "Win32/UI/ListView.h"
+#include "Win32/WindowUtil.h"
 
 #include "RenameDialog.h"
 
 #include "csMenu3Resource.h"
 #include "RenameDialogResource.h"
 
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_renamedialog {
+
+  // Update the preview once the user stops typing for this long...
+  constexpr UINT_t PREVIEW_DELAY_MS = 150;
+
+  // Redraw the whole list, if more rows changed...
+  constexpr std::size_t PREVIEW_MAX_REDRAW = 256;
+
+  constexpr UINT_PTR_t TIMER_PREVIEW = 1;
+
+  constexpr UINT_t WM_PREVIEW = ui::DIALOG_USER + 1;
+
+  constexpr COLORREF COLLISION_BACK = RGB(255, 224, 224);
+  constexpr COLORREF COLLISION_TEXT = RGB(192, 0, 0);
+
+} // namespace impl_renamedialog
+
 ////// public ////////////////////////////////////////////////////////////////
 
-RenameDialog::RenameDialog() noexcept
+RenameDialog::RenameDialog(const cs::PathList& files) noexcept
   : data()
 {
+  try {
+    _files = files;
+  } catch( ... ) {
+    _files.clear();
+  }
 }
 
 RenameDialog::~RenameDialog() noexcept
 {
+  stopPreview();
 }
 
-LRESULT_t RenameDialog::onOk(WPARAM_t wParam, LPARAM_t lParam)
+bool RenameDialog::exec(HINSTANCE_t instance, HWND_t parent)
 {
-  ui::ComboBox *modeCombo        = ui::COMBOBOX(getControl(ID_ComboMode));
-  ui::CheckBox *isExtensionCheck = ui::CHECKBOX(getControl(ID_CheckExtension));
-  ui::EditText *patternEdit      = ui::EDITTEXT(getControl(ID_EditPattern));
-  ui::EditText *replaceEdit      = ui::EDITTEXT(getControl(ID_EditReplace));
+  if( !ui::ListView::initialize() ) {
+    return false;
+  }
+  return Dialog::exec(instance, parent);
+}
 
-  if( modeCombo->currentText() == L"Append" ) {
-    data.mode = Rename::Append;
-  } else if( modeCombo->currentText() == L"Prepend" ) {
-    data.mode = Rename::Prepend;
-  } else if( modeCombo->currentText() == L"Remove" ) {
-    data.mode = Rename::Remove;
-  } else if( modeCombo->currentText() == L"Replace" ) {
-    data.mode = Rename::Replace;
-  } else {
-    data.mode = Rename::Invalid;
+LRESULT_t RenameDialog::onCancel(WPARAM_t wParam, LPARAM_t lParam)
+{
+  stopPreview();
+
+  return Dialog::onCancel(wParam, lParam);
+}
+
+LRESULT_t RenameDialog::onCommand(WPARAM_t wParam, LPARAM_t lParam)
+{
+  const int id   = LOWORD(wParam);
+  const int code = HIWORD(wParam);
+
+  const bool is_changed = ((id == ID_EditPattern || id == ID_EditReplace) && code == EN_CHANGE) ||
+      (id == ID_ComboMode && code == CBN_SELCHANGE) ||
+      (id == ID_CheckExtension && code == BN_CLICKED);
+
+  const LRESULT_t result = Dialog::onCommand(wParam, lParam);
+
+  if( is_changed && _preview ) { // (Re-)Start the debounce timer
+    setTimer(impl_renamedialog::TIMER_PREVIEW, impl_renamedialog::PREVIEW_DELAY_MS);
   }
 
-  data.pattern     = patternEdit->text();
-  data.replace     = replaceEdit->text();
-  data.isExtension = isExtensionCheck->isChecked();
+  return result;
+}
+
+LRESULT_t RenameDialog::onNotify(WPARAM_t /*wParam*/, LPARAM_t lParam)
+{
+  using namespace impl_renamedialog;
+
+  const NMHDR *hdr = reinterpret_cast<const NMHDR *>(lParam);
+  if( hdr->idFrom != ID_ListPreview || !_preview ) {
+    return FALSE;
+  }
+
+  if( hdr->code == LVN_GETDISPINFOW ) {
+    NMLVDISPINFOW *info = reinterpret_cast<NMLVDISPINFOW *>(lParam);
+    if( (info->item.mask & LVIF_TEXT) == 0 || info->item.cchTextMax < 1 ) {
+      return FALSE;
+    }
+
+    if( !_preview->row(static_cast<std::size_t>(info->item.iItem), _row) ) {
+      info->item.pszText[0] = L'\0';
+      return FALSE;
+    }
+
+    const std::wstring& text = info->item.iSubItem == 0 || _row.target.empty()
+                               ? _row.name
+                               : _row.target;
+    wcsncpy_s(info->item.pszText, info->item.cchTextMax, text.data(), _TRUNCATE);
+
+  } else if( hdr->code == NM_CUSTOMDRAW ) {
+    NMLVCUSTOMDRAW *draw = reinterpret_cast<NMLVCUSTOMDRAW *>(lParam);
+
+    if( draw->nmcd.dwDrawStage == CDDS_PREPAINT ) {
+      return CDRF_NOTIFYITEMDRAW;
+    } else if( draw->nmcd.dwDrawStage == CDDS_ITEMPREPAINT &&
+               _preview->isCollision(static_cast<std::size_t>(draw->nmcd.dwItemSpec)) ) {
+      draw->clrText   = COLLISION_TEXT;
+      draw->clrTextBk = COLLISION_BACK;
+      return CDRF_NEWFONT;
+    }
+    return CDRF_DODEFAULT;
+  }
+
+  return FALSE;
+}
+
+LRESULT_t RenameDialog::onOk(WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
+{
+  stopPreview();
+
+  data = currentRename();
+
+  return TRUE;
+}
+
+LRESULT_t RenameDialog::onTimer(WPARAM_t wParam, LPARAM_t /*lParam*/)
+{
+  if( wParam != impl_renamedialog::TIMER_PREVIEW ) {
+    return FALSE;
+  }
+
+  killTimer(impl_renamedialog::TIMER_PREVIEW);
+  requestPreview(currentRename());
+
+  return TRUE;
+}
+
+LRESULT_t RenameDialog::onUser(UINT_t msg, WPARAM_t /*wParam*/, LPARAM_t /*lParam*/)
+{
+  if( msg != impl_renamedialog::WM_PREVIEW ) {
+    return FALSE;
+  }
+
+  updatePreview();
 
   return TRUE;
 }
@@ -91,6 +203,8 @@ LRESULT_t RenameDialog::onInitDialog(HWND_t wnd, LPARAM_t lParam)
   ui::COMBOBOX(modeCombo)->addItem(L"Prepend");
   ui::COMBOBOX(modeCombo)->addItem(L"Remove");
   ui::COMBOBOX(modeCombo)->addItem(L"Replace");
+  ui::COMBOBOX(modeCombo)->addItem(L"Regex");
+  ui::COMBOBOX(modeCombo)->addItem(L"Multi");
   ui::COMBOBOX(modeCombo)->setCurrentIndex(0);
   _controls.push_back(std::move(modeCombo));
 
@@ -98,6 +212,27 @@ LRESULT_t RenameDialog::onInitDialog(HWND_t wnd, LPARAM_t lParam)
 
   _controls.push_back(ui::EditText::create(wnd, ID_EditReplace));
 
+  // Preview /////////////////////////////////////////////////////////////////
+
+  ui::WindowPtr previewList = ui::ListView::create(wnd, ID_ListPreview);
+  ui::LISTVIEW(previewList)->setFullRowSelect(true);
+  ui::LISTVIEW(previewList)->insertColumn(0, L"Name", ui::LISTVIEW(previewList)->width()/2);
+  ui::LISTVIEW(previewList)->insertColumn(1, L"New Name", ui::LISTVIEW(previewList)->width()/2);
+
+  _preview = RenamePreview::make(_files);
+  if( _preview ) {
+    ui::LISTVIEW(previewList)->setItemCount(static_cast<int>(_preview->size()));
+
+    try {
+      _worker = std::thread(&RenameDialog::previewLoop, this);
+    } catch( ... ) {
+      _preview.reset();
+    }
+  }
+  _controls.push_back(std::move(previewList));
+
+  updatePreview();
+
   return result;
 }
 
@@ -115,3 +250,141 @@ const wchar_t *RenameDialog::wndClassName() const
 {
   return WNDCLASS_RenameDialog;
 }
+
+////// private ///////////////////////////////////////////////////////////////
+
+Rename RenameDialog::currentRename() const
+{
+  ui::ComboBox *modeCombo        = ui::COMBOBOX(getControl(ID_ComboMode));
+  ui::CheckBox *isExtensionCheck = ui::CHECKBOX(getControl(ID_CheckExtension));
+  ui::EditText *patternEdit      = ui::EDITTEXT(getControl(ID_EditPattern));
+  ui::EditText *replaceEdit      = ui::EDITTEXT(getControl(ID_EditReplace));
+
+  Rename result;
+  if( modeCombo->currentText() == L"Append" ) {
+    result.mode = Rename::Append;
+  } else if( modeCombo->currentText() == L"Prepend" ) {
+    result.mode = Rename::Prepend;
+  } else if( modeCombo->currentText() == L"Remove" ) {
+    result.mode = Rename::Remove;
+  } else if( modeCombo->currentText() == L"Replace" ) {
+    result.mode = Rename::Replace;
+  } else if( modeCombo->currentText() == L"Regex" ) {
+    result.mode = Rename::Regex;
+  } else if( modeCombo->currentText() == L"Multi" ) {
+    result.mode = Rename::Multi;
+  } else {
+    result.mode = Rename::Invalid;
+  }
+
+  result.pattern     = patternEdit->text();
+  result.replace     = replaceEdit->text();
+  result.isExtension = isExtensionCheck->isChecked();
+
+  return result;
+}
+
+void RenameDialog::previewLoop()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  while( true ) {
+    _cond.wait(lock, [this]() -> bool {
+      return _stop || _request.has_value();
+    });
+    if( _stop ) {
+      return;
+    }
+
+    const Rename rename       = std::move(*_request);
+    const unsigned generation = _generation;
+    _request.reset();
+    lock.unlock();
+
+    RenamePreview::Indices changed;
+    const bool is_updated = _preview->update(rename, changed, [&]() -> bool {
+      return _stop || _generation != generation;
+    });
+
+    lock.lock();
+    if( is_updated ) {
+      _changed.insert(_changed.end(), changed.begin(), changed.end());
+      postMessage(impl_renamedialog::WM_PREVIEW, 0, 0);
+    }
+  }
+}
+
+void RenameDialog::requestPreview(const Rename& rename)
+{
+  if( !_preview ) {
+    return;
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    try {
+      _request = rename;
+    } catch( ... ) {
+      return;
+    }
+    _generation++;
+  }
+
+  _cond.notify_one();
+}
+
+void RenameDialog::stopPreview()
+{
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+
+  _cond.notify_one();
+
+  if( _worker.joinable() ) {
+    _worker.join();
+  }
+}
+
+void RenameDialog::updatePreview()
+{
+  using namespace impl_renamedialog;
+
+  ui::ListView *previewList = ui::LISTVIEW(getControl(ID_ListPreview));
+  if( previewList == nullptr || !_preview ) {
+    return;
+  }
+
+  RenamePreview::Indices changed;
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    changed.swap(_changed);
+  }
+
+  // (1) Redraw changed rows, in runs ////////////////////////////////////////
+
+  if( changed.size() > PREVIEW_MAX_REDRAW ) {
+    previewList->redrawAll();
+  } else {
+    std::sort(changed.begin(), changed.end());
+    for( std::size_t i = 0; i < changed.size(); ) {
+      std::size_t last = i;
+      while( last + 1 < changed.size() && changed[last + 1] <= changed[last] + 1 ) {
+        last++;
+      }
+
+      previewList->redrawItems(static_cast<int>(changed[i]), static_cast<int>(changed[last]));
+      i = last + 1;
+    }
+  }
+
+  // (2) Status //////////////////////////////////////////////////////////////
+
+  try {
+    const std::wstring status = std::format(L"{} file(s), {} collision(s)",
+                                            _preview->size(), _preview->numCollisions());
+    window::setText(GetDlgItem(reinterpret_cast<HWND>(handle()), ID_LabelStatus), status.data());
+  } catch( ... ) {
+  }
+}
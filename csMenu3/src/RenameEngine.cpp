@@ -0,0 +1,175 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "RenameEngine.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_renameengine {
+
+  constexpr wchar_t DOT = L'.';
+
+  constexpr std::size_t NPOS = std::wstring_view::npos;
+  constexpr std::size_t ONE  = 1;
+  constexpr std::size_t ZERO = 0;
+
+  std::wstring_view leafName(const std::wstring_view& path)
+  {
+    const std::size_t posSep = path.find_last_of(L"\\/");
+    return posSep != NPOS
+           ? path.substr(posSep + ONE)
+           : path;
+  }
+
+  // Appends item, with all occurrences of pattern substituted by replace.
+  void replaceAll(std::wstring& result, const std::wstring_view& item,
+                  const std::wstring_view& pattern, const std::wstring_view& replace)
+  {
+    std::size_t last = ZERO;
+    for( std::size_t pos = item.find(pattern); pos != NPOS; pos = item.find(pattern, last) ) {
+      result.append(item.substr(last, pos - last));
+      result.append(replace);
+      last = pos + pattern.size();
+    }
+    result.append(item.substr(last));
+  }
+
+} // namespace impl_renameengine
+
+////// public ////////////////////////////////////////////////////////////////
+
+RenameEngine::RenameEngine(const Rename& rename) noexcept
+{
+  try {
+    _rename = rename;
+
+    if( _rename.mode == Rename::Regex ) {
+      _regex = Regex(_rename.pattern, _rename.replace);
+    } else if( _rename.mode == Rename::Multi ) {
+      _multi = MultiReplace(_rename.pattern, _rename.replace);
+    }
+  } catch( ... ) {
+    _rename = Rename();
+  }
+}
+
+RenameEngine::~RenameEngine() noexcept
+{
+}
+
+bool RenameEngine::isValid() const
+{
+  return _rename.isValid() &&
+      (_rename.mode != Rename::Regex || _regex.isValid()) &&
+      (_rename.mode != Rename::Multi || _multi.isValid());
+}
+
+bool RenameEngine::newName(std::wstring& result, const std::filesystem::path& path) const
+{
+  return newName(result, impl_renameengine::leafName(path.native()));
+}
+
+bool RenameEngine::newName(std::wstring& result, const std::wstring_view& filename) const
+{
+  using namespace impl_renameengine;
+
+  result.clear();
+  if( !isValid() || filename.empty() ) {
+    return false;
+  }
+
+  try {
+    // (1) Split filename into stem & extension //////////////////////////////
+
+    const std::size_t posDot = filename.rfind(DOT);
+    const bool has_ext       = posDot != ZERO && posDot != NPOS;
+
+    const std::wstring_view stem = has_ext
+                                   ? filename.substr(ZERO, posDot)
+                                   : filename;
+    const std::wstring_view ext  = has_ext
+                                   ? filename.substr(posDot + ONE)
+                                   : std::wstring_view();
+
+    // (2) Rename work item into result //////////////////////////////////////
+
+    if( _rename.isExtension ) {
+      result.append(stem);
+      result.push_back(DOT);
+      apply(result, ext);
+      if( result.size() == stem.size() + ONE ) { // No extension
+        result.pop_back();
+      }
+    } else {
+      apply(result, stem);
+      if( has_ext ) {
+        result.push_back(DOT);
+        result.append(ext);
+      }
+    }
+
+    // (3) Sanity check //////////////////////////////////////////////////////
+
+    const bool is_empty = _rename.isExtension
+                          ? stem.empty()
+                          : result.size() == (has_ext ? ext.size() + ONE : ZERO);
+    if( is_empty || result == filename ) {
+      result.clear();
+      return false;
+    }
+  } catch( ... ) {
+    result.clear();
+    return false;
+  }
+
+  return true;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void RenameEngine::apply(std::wstring& result, const std::wstring_view& item) const
+{
+  if( _rename.mode == Rename::Append ) {
+    result.append(item);
+    result.append(_rename.pattern);
+  } else if( _rename.mode == Rename::Prepend ) {
+    result.append(_rename.pattern);
+    result.append(item);
+  } else if( _rename.mode == Rename::Remove ) {
+    impl_renameengine::replaceAll(result, item, _rename.pattern, std::wstring_view());
+  } else if( _rename.mode == Rename::Replace ) {
+    impl_renameengine::replaceAll(result, item, _rename.pattern, _rename.replace);
+  } else if( _rename.mode == Rename::Regex ) {
+    _regex.replaceAll(result, item);
+  } else if( _rename.mode == Rename::Multi ) {
+    _multi.replaceAll(result, item);
+  }
+}
@@ -0,0 +1,427 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdint>
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "RenamePlan.h"
+
+#include "FileName.h"
+#include "ThreadPool.h"
+#include "Util.h"
+#include "Win32/FileInfo.h"
+#include "Win32/FileOp.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_renameplan {
+
+  // List a directory, if at least this many of its entries are renamed...
+  constexpr std::size_t LIST_MIN_PENDING = 8;
+
+  constexpr std::size_t MAX_RENAME_THREADS = 8;
+
+  constexpr std::size_t MAX_REPORT_ITEMS = 16;
+
+  constexpr std::size_t NONE = SIZE_MAX;
+
+  using Keys = std::unordered_map<std::wstring, std::size_t>; // Folded name -> Index
+
+  std::wstring_view leafName(const std::wstring_view& path)
+  {
+    const std::size_t posSep = path.find_last_of(L"\\/");
+    return posSep != std::wstring_view::npos
+           ? path.substr(posSep + 1)
+           : path;
+  }
+
+  const wchar_t *statusName(const RenamePlan::Status status)
+  {
+    if( status == RenamePlan::Status::Collision ) {
+      return L"Collision";
+    } else if( status == RenamePlan::Status::Exists ) {
+      return L"Exists";
+    } else if( status == RenamePlan::Status::Blocked ) {
+      return L"Blocked";
+    } else if( status == RenamePlan::Status::Failed ) {
+      return L"Failed";
+    } else if( status == RenamePlan::Status::Stranded ) {
+      return L"Stranded";
+    }
+    return L"";
+  }
+
+  // Calls func(i) for i in [0, count), on up to MAX_RENAME_THREADS threads.
+  template <typename Func>
+  void forEachParallel(const std::size_t count, Func&& func)
+  {
+    ThreadPool::instance().forEach(count, MAX_RENAME_THREADS, std::forward<Func>(func));
+  }
+
+} // namespace impl_renameplan
+
+////// public ////////////////////////////////////////////////////////////////
+
+RenamePlan::RenamePlan() noexcept
+{
+}
+
+RenamePlan::~RenamePlan() noexcept
+{
+}
+
+bool RenamePlan::plan(const cs::PathList& files, const RenameEngine& engine)
+{
+  using namespace impl_renameplan;
+
+  _items.clear();
+  _groups.clear();
+
+  try {
+    _items.reserve(files.size());
+
+    // (1) Compute targets & group by directory //////////////////////////////
+
+    Keys directories;
+    std::wstring name;
+    for( const std::filesystem::path& file : files ) {
+      Item item{file};
+      if( engine.newName(name, file) ) {
+        item.target = name;
+        item.status = Status::Pending;
+      }
+
+      std::filesystem::path directory = file.parent_path();
+
+      const auto [iter, is_new] = directories.emplace(foldFileName(directory.native()), _groups.size());
+      if( is_new ) {
+        _groups.push_back(Group{std::move(directory)});
+      }
+
+      _groups[iter->second].items.push_back(_items.size());
+      _items.push_back(std::move(item));
+    }
+
+    // (2) Plan each directory ///////////////////////////////////////////////
+
+    forEachParallel(_groups.size(), [this](const std::size_t i) -> void {
+      planGroup(_groups[i]);
+    });
+  } catch( ... ) {
+    _items.clear();
+    _groups.clear();
+    return false;
+  }
+
+  return true;
+}
+
+std::size_t RenamePlan::execute()
+{
+  using namespace impl_renameplan;
+
+  struct Chain {
+    std::size_t group{0};
+    std::size_t chain{0};
+  };
+
+  try {
+    // (1) Open each directory once; shared by all of its chains /////////////
+
+    std::vector<std::unique_ptr<fileop::Directory>> directories(_groups.size());
+    forEachParallel(_groups.size(), [&](const std::size_t i) -> void {
+      directories[i] = std::make_unique<fileop::Directory>(_groups[i].directory.c_str());
+    });
+
+    // (2) Execute the chains of all directories /////////////////////////////
+
+    std::vector<Chain> chains;
+    for( std::size_t i = 0; i < _groups.size(); i++ ) {
+      for( std::size_t c = 0; c < _groups[i].chains.size(); c++ ) {
+        chains.push_back(Chain{i, c});
+      }
+    }
+
+    forEachParallel(chains.size(), [&](const std::size_t i) -> void {
+      const Chain& chain = chains[i];
+      executeChain(*directories[chain.group], _groups[chain.group], chain.chain);
+    });
+  } catch( ... ) {
+  }
+
+  return count(Status::Renamed);
+}
+
+std::size_t RenamePlan::count(const Status status) const
+{
+  return static_cast<std::size_t>(std::count_if(_items.cbegin(), _items.cend(),
+                                                [status](const Item& item) -> bool {
+                                                  return item.status == status;
+                                                }));
+}
+
+const RenamePlan::Items& RenamePlan::items() const
+{
+  return _items;
+}
+
+std::wstring RenamePlan::report() const
+{
+  using namespace impl_renameplan;
+
+  std::wstring result;
+  try {
+    result = std::format(L"Renamed {} of {} file(s).", count(Status::Renamed), _items.size());
+
+    std::size_t numReported = 0;
+    for( const Item& item : _items ) {
+      const wchar_t *status = statusName(item.status);
+      if( *status == L'\0' ) {
+        continue;
+      }
+
+      result += EOL;
+      if( ++numReported > MAX_REPORT_ITEMS ) {
+        result += L"...";
+        break;
+      }
+
+      result += std::format(L"{}: {} -> {}", status, leafName(item.source.native()), item.target);
+      if( item.status == Status::Stranded ) {
+        result += std::format(L" (left as {})", item.current);
+      }
+    }
+  } catch( ... ) {
+    result.clear();
+  }
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+/*
+ * NOTE: A chain's steps depend on each other, while different chains never
+ *       touch the same names; hence, chains run in parallel & share their
+ *       directory's handle.
+ */
+
+void RenamePlan::executeChain(fileop::Directory& directory, const Group& group, const std::size_t chain)
+{
+  const std::size_t first = group.chains[chain];
+  const std::size_t last  = chain + 1 < group.chains.size()
+                            ? group.chains[chain + 1]
+                            : group.steps.size();
+
+  for( std::size_t s = first; s < last; s++ ) {
+    const Step& step = group.steps[s];
+    Item& item       = _items[step.item];
+
+    if( step.kind == StepKind::FromTemporary && item.status == Status::Failed ) {
+      continue; // Never moved to its temporary name
+    }
+
+    const bool is_renamed = directory.rename(step.from, step.to);
+
+    if( step.kind == StepKind::ToTemporary ) {
+      if( !is_renamed ) {
+        item.status = Status::Failed;
+      }
+      continue;
+    }
+
+    item.status = is_renamed
+                  ? Status::Renamed
+                  : Status::Failed;
+
+    // NOTE: In a cycle, the original name is most likely taken by now...
+    if( !is_renamed && step.kind == StepKind::FromTemporary &&
+        !directory.rename(step.from, impl_renameplan::leafName(item.source.native())) ) {
+      item.status  = Status::Stranded;
+      item.current = step.from;
+    }
+  }
+}
+
+void RenamePlan::planGroup(Group& group)
+{
+  using namespace impl_renameplan;
+
+  const std::size_t numItems = group.items.size();
+
+  const auto lambda_item = [&](const std::size_t k) -> Item& {
+    return _items[group.items[k]];
+  };
+
+  const auto lambda_pending = [&](const std::size_t k) -> bool {
+    return k != NONE && lambda_item(k).status == Status::Pending;
+  };
+
+  std::size_t numPending = 0;
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    numPending += lambda_pending(k) ? 1 : 0;
+  }
+
+  if( numPending < 1 ) {
+    return;
+  }
+
+  // (1) Sources: Every selected file occupies its name //////////////////////
+
+  std::vector<std::wstring> sourceKeys(numItems);
+  std::vector<std::wstring> targetKeys(numItems);
+
+  Keys sources;
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    sourceKeys[k] = foldFileName(leafName(lambda_item(k).source.native()));
+    sources.emplace(sourceKeys[k], k);
+  }
+
+  // (2) Collisions: Targets shared by several files /////////////////////////
+
+  Keys targets;
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    if( !lambda_pending(k) ) {
+      continue;
+    }
+
+    targetKeys[k] = foldFileName(lambda_item(k).target);
+
+    const auto [iter, is_new] = targets.emplace(targetKeys[k], k);
+    if( !is_new ) {
+      lambda_item(iter->second).status = Status::Collision;
+      lambda_item(k).status            = Status::Collision;
+    }
+  }
+
+  // (3) Existing objects, listed if many files are renamed //////////////////
+
+  std::unordered_set<std::wstring> existing;
+
+  const bool is_listed = numPending >= LIST_MIN_PENDING &&
+      fileinfo::list(group.directory.c_str(), [&](const std::wstring_view& name, const fileinfo::Info&) -> void {
+        existing.insert(foldFileName(name));
+      });
+
+  const auto lambda_exists = [&](const std::wstring& key, const std::wstring& name) -> bool {
+    if( is_listed ) {
+      return existing.contains(key);
+    }
+    return fileinfo::query((group.directory / name).c_str()).type != fileinfo::Type::Invalid;
+  };
+
+  // (4) Dependencies: Targets occupied by files being renamed ///////////////
+
+  std::vector<std::size_t> dependency(numItems, NONE); // Waits for...
+  std::vector<std::size_t> dependent(numItems, NONE);  // ...is waited for by
+
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    if( !lambda_pending(k) || targetKeys[k] == sourceKeys[k] ) { // e.g. case only
+      continue;
+    }
+
+    const Keys::const_iterator occupant = sources.find(targetKeys[k]);
+    if( occupant != sources.cend() ) {
+      const std::size_t o = occupant->second;
+      if( lambda_pending(o) && targetKeys[o] != sourceKeys[o] ) {
+        dependency[k] = o;
+        dependent[o]  = k;
+      } else {
+        lambda_item(k).status = Status::Exists;
+      }
+    } else if( lambda_exists(targetKeys[k], lambda_item(k).target) ) {
+      lambda_item(k).status = Status::Exists;
+    }
+  }
+
+  // (5) Block chains waiting for a file that stays in place /////////////////
+
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    if( !lambda_pending(k) || dependency[k] == NONE || lambda_pending(dependency[k]) ) {
+      continue;
+    }
+
+    for( std::size_t x = k; lambda_pending(x); x = dependent[x] ) {
+      lambda_item(x).status = Status::Blocked;
+    }
+  }
+
+  // (6) Steps: Chains from their free end, cycles via a temporary name //////
+
+  std::vector<bool> is_planned(numItems, false);
+
+  const auto lambda_step = [&](const std::size_t k, const std::wstring_view& from,
+                               const std::wstring& to, const StepKind kind) -> void {
+    group.steps.push_back(Step{group.items[k], std::wstring(from), to, kind});
+  };
+
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    if( !lambda_pending(k) || dependency[k] != NONE ) {
+      continue;
+    }
+
+    group.chains.push_back(group.steps.size());
+    for( std::size_t x = k; x != NONE && !is_planned[x]; x = dependent[x] ) {
+      lambda_step(x, leafName(lambda_item(x).source.native()), lambda_item(x).target, StepKind::Direct);
+      is_planned[x] = true;
+    }
+  }
+
+  std::size_t numTemporary = 0;
+  for( std::size_t k = 0; k < numItems; k++ ) {
+    if( !lambda_pending(k) || is_planned[k] ) {
+      continue;
+    }
+
+    std::wstring temporary;
+    do {
+      temporary = std::format(L"~rename.{}.tmp", numTemporary++);
+    } while( sources.contains(foldFileName(temporary)) || targets.contains(foldFileName(temporary)) ||
+             lambda_exists(foldFileName(temporary), temporary) );
+
+    group.chains.push_back(group.steps.size());
+    lambda_step(k, leafName(lambda_item(k).source.native()), temporary, StepKind::ToTemporary);
+    is_planned[k] = true;
+
+    for( std::size_t x = dependent[k]; x != NONE && !is_planned[x]; x = dependent[x] ) {
+      lambda_step(x, leafName(lambda_item(x).source.native()), lambda_item(x).target, StepKind::Direct);
+      is_planned[x] = true;
+    }
+
+    lambda_step(k, temporary, lambda_item(k).target, StepKind::FromTemporary);
+  }
+}
@@ -0,0 +1,296 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <string_view>
+
+#include "RenamePreview.h"
+
+#include "FileName.h"
+#include "RenameEngine.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_preview {
+
+  // Poll for cancellation every so many rows...
+  constexpr std::size_t CANCEL_INTERVAL = 1024;
+
+  std::wstring_view leafName(const std::wstring_view& path)
+  {
+    const std::size_t posSep = path.find_last_of(L"\\/");
+    return posSep != std::wstring_view::npos
+           ? path.substr(posSep + 1)
+           : path;
+  }
+
+  bool isLiteral(const Rename& rename)
+  {
+    return rename.mode == Rename::Remove || rename.mode == Rename::Replace;
+  }
+
+} // namespace impl_preview
+
+////// public ////////////////////////////////////////////////////////////////
+
+RenamePreview::RenamePreview(const ctor_tag&) noexcept
+{
+}
+
+RenamePreview::~RenamePreview() noexcept
+{
+}
+
+bool RenamePreview::isCollision(const std::size_t index) const
+{
+  const std::lock_guard<std::mutex> lock(_mutex);
+  return index < _isCollision.size() && _isCollision[index];
+}
+
+std::size_t RenamePreview::numCollisions() const
+{
+  const std::lock_guard<std::mutex> lock(_mutex);
+  return _numCollisions;
+}
+
+bool RenamePreview::row(const std::size_t index, Row& result) const
+{
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  if( index >= _names.size() ) {
+    return false;
+  }
+
+  try {
+    result.name        = _names[index];
+    result.target      = _targets[index];
+    result.isCollision = _isCollision[index];
+  } catch( ... ) {
+    return false;
+  }
+
+  return true;
+}
+
+std::size_t RenamePreview::size() const
+{
+  return _names.size(); // Constant after make()
+}
+
+bool RenamePreview::update(const Rename& rename, Indices& changed,
+                           const CancelFunc& isCancelled)
+{
+  using namespace impl_preview;
+
+  const std::lock_guard<std::mutex> serialize(_update);
+
+  try {
+    const RenameEngine engine(rename);
+    const bool is_valid    = engine.isValid();
+    const bool is_extended = is_valid && isExtended(rename);
+
+    // (1) Compute new names, w/o blocking readers ///////////////////////////
+
+    std::vector<bool> candidates(_isCandidate);
+    Targets targets;
+
+    std::wstring target;
+    for( std::size_t i = 0; i < _names.size(); i++ ) {
+      if( i % CANCEL_INTERVAL == 0 && isCancelled && isCancelled() ) {
+        return false;
+      }
+
+      if( is_extended && !_isCandidate[i] ) {
+        continue; // Can not contain the extended pattern, either
+      }
+
+      candidates[i] = !isLiteral(rename) || _names[i].find(rename.pattern) != std::wstring::npos;
+
+      if( !is_valid || !engine.newName(target, std::wstring_view(_names[i])) ) {
+        target.clear();
+      }
+
+      if( target != _targets[i] ) {
+        targets.emplace_back(i, target);
+      }
+    }
+
+    if( isCancelled && isCancelled() ) {
+      return false;
+    }
+
+    // (2) Apply changes /////////////////////////////////////////////////////
+
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    for( auto& [index, name] : targets ) {
+      vacate(index, changed);
+      _targets[index] = std::move(name);
+      occupy(index, changed);
+
+      changed.push_back(index);
+    }
+
+    _isCandidate = std::move(candidates);
+    _rename      = rename;
+  } catch( ... ) {
+    return false;
+  }
+
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+  return true;
+}
+
+RenamePreviewPtr RenamePreview::make(const cs::PathList& files)
+{
+  RenamePreviewPtr result;
+
+  try {
+    result = std::make_shared<RenamePreview>(ctor_tag());
+
+    std::unordered_map<std::wstring, uint32_t> directories;
+    for( const std::filesystem::path& file : files ) {
+      const std::wstring_view filename = file.native();
+      const std::wstring_view name     = impl_preview::leafName(filename);
+
+      const std::wstring directory = foldFileName(filename.substr(0, filename.size() - name.size()));
+
+      const auto [iter, is_new] = directories.emplace(directory, static_cast<uint32_t>(directories.size()));
+
+      result->_names.emplace_back(name);
+      result->_directories.push_back(iter->second);
+    }
+
+    const std::size_t numRows = result->_names.size();
+    result->_targets.resize(numRows);
+    result->_isCandidate.assign(numRows, true);
+    result->_isCollision.assign(numRows, false);
+    result->_positions.assign(numRows, 0);
+
+    Indices ignored;
+    for( std::size_t i = 0; i < numRows; i++ ) {
+      result->occupy(i, ignored);
+    }
+  } catch( ... ) {
+    return RenamePreviewPtr{};
+  }
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+RenamePreview::ctor_tag::ctor_tag() noexcept
+{
+}
+
+bool RenamePreview::isExtended(const Rename& rename) const
+{
+  return impl_preview::isLiteral(rename) &&
+      rename.mode == _rename.mode &&
+      rename.isExtension == _rename.isExtension &&
+      rename.replace == _rename.replace &&
+      !_rename.pattern.empty() &&
+      rename.pattern.find(_rename.pattern) != std::wstring::npos;
+}
+
+/*
+ * NOTE: The key of the name occupied by a row, prefixed by its directory's
+ *       (16 bit halves of its) id; i.e. rows only ever collide within their
+ *       directory.
+ */
+
+std::wstring RenamePreview::key(const std::size_t index) const
+{
+  const uint32_t directory = _directories[index];
+
+  std::wstring result;
+  result.push_back(static_cast<wchar_t>(directory & 0xFFFF));
+  result.push_back(static_cast<wchar_t>(directory >> 16));
+  result += foldFileName(_targets[index].empty()
+                         ? _names[index]
+                         : _targets[index]);
+
+  return result;
+}
+
+void RenamePreview::occupy(const std::size_t index, Indices& affected)
+{
+  std::vector<uint32_t>& rows = _occupants[key(index)];
+  _positions[index]           = static_cast<uint32_t>(rows.size());
+  rows.push_back(static_cast<uint32_t>(index));
+
+  if( rows.size() == 2 ) {
+    setCollision(rows.front(), true, affected);
+  }
+  if( rows.size() > 1 ) {
+    setCollision(index, true, affected);
+  }
+}
+
+void RenamePreview::setCollision(const std::size_t index, const bool on, Indices& affected)
+{
+  if( _isCollision[index] == on ) {
+    return;
+  }
+
+  _isCollision[index] = on;
+  _numCollisions      = on
+                        ? _numCollisions + 1
+                        : _numCollisions - 1;
+
+  affected.push_back(index);
+}
+
+void RenamePreview::vacate(const std::size_t index, Indices& affected)
+{
+  const Occupants::iterator iter = _occupants.find(key(index));
+  if( iter == _occupants.end() ) {
+    return;
+  }
+
+  std::vector<uint32_t>& rows = iter->second;
+
+  // Move the last occupant into the vacated position...
+  const uint32_t position    = _positions[index];
+  rows[position]             = rows.back();
+  _positions[rows[position]] = position;
+  rows.pop_back();
+
+  setCollision(index, false, affected);
+  if( rows.size() == 1 ) {
+    setCollision(rows.front(), false, affected);
+  } else if( rows.empty() ) {
+    _occupants.erase(iter);
+  }
+}
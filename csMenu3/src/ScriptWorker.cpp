@@ -30,14 +30,12 @@
 *****************************************************************************/
 
 #include <algorithm>
-#include <atomic>
-#include <thread>
-
-#include <cs/Concurrent/Map.h>
+#include <iterator>
 
 #include "ScriptWorker.h"
 
 #include "FileName.h"
+#include "ThreadPool.h"
 #include "Win32/Message.h"
 #include "Win32/MessageBox.h"
 #include "Win32/ProgressBar.h"
@@ -46,8 +44,6 @@
 
 ////// Imports ///////////////////////////////////////////////////////////////
 
-namespace conc = cs::concurrent;
-
 extern HANDLE_t getInstDLL(); // main.cpp
 
 ////// Parallel //////////////////////////////////////////////////////////////
@@ -56,10 +52,10 @@ namespace impl_parallel {
 
   class Worker {
   public:
-    Worker(const std::filesystem::path& script,
+    Worker(const shell::Launcher *launcher,
            const ProgressBar *progress = nullptr) noexcept
-      : _progress(progress)
-      , _script(script)
+      : _launcher(launcher)
+      , _progress(progress)
     {
     }
 
@@ -69,10 +65,24 @@ namespace impl_parallel {
 
     void operator()(const std::filesystem::path& filename) const
     {
-      if( !_script.empty() && !filename.empty() ) {
-        const std::wstring exec = _script;
-        const std::wstring arg  = quotedFileName(filename);
-        shell::execute(exec.data(), arg.data());
+      execute(!filename.empty()
+              ? quotedFileName(filename)
+              : NativeString{});
+    }
+
+    // Batch of filenames; cf. batchFileNames()
+    void operator()(const NativeString& arguments) const
+    {
+      execute(arguments);
+    }
+
+  private:
+    Worker() noexcept = delete;
+
+    void execute(const NativeString& arguments) const
+    {
+      if( _launcher != nullptr && !arguments.empty() ) {
+        _launcher->execute(arguments.data());
       }
 
       if( _progress != nullptr ) {
@@ -84,59 +94,101 @@ namespace impl_parallel {
       }
     }
 
-  private:
-    Worker() noexcept = delete;
-
+    const shell::Launcher *_launcher{nullptr};
     const ProgressBar *_progress{nullptr};
-    std::filesystem::path _script{};
   };
 
-} // namespace impl_parallel
+  // Runs the launcher for each item in [first, last) on the thread pool,
+  // showing progress; cf. Worker.
+  template <typename Iter>
+  bool run(Iter first, Iter last, const std::size_t numThreads, const shell::Launcher& launcher)
+  {
+    if( !window::makeGUIThread() ) {
+      messagebox::error(L"makeGUIThread()");
+      return false;
+    }
+
+    ProgressBarPtr progress = ProgressBar::make(getInstDLL(), 480, 48);
+    if( !progress ) {
+      messagebox::error(L"ProgressBar::make()");
+      return false;
+    }
 
-using Worker = impl_parallel::Worker;
+    progress->setPostQuitOnDestroy(true);
+    progress->setRange(0, static_cast<int>(std::distance(first, last)));
+    progress->show();
+
+    auto future = ThreadPool::instance().forEachAsync(first, last, numThreads,
+                                                      Worker(&launcher, progress.get()));
+    message::loop();
+    future.get();
+
+    return true;
+  }
+
+} // namespace impl_parallel
 
 ////// Public ////////////////////////////////////////////////////////////////
 
 void batch_work(WorkContext ctx)
 {
-  const std::wstring exec = ctx.script;
-  const std::wstring args = joinFileNames(ctx.files);
-  shell::execute(exec.data(), args.data());
+  const shell::Launcher launcher(ctx.script.c_str());
+
+  const NativeStrings batches = batchFileNames(ctx.files, launcher.maxArguments(), ctx.batchSize);
+  if( batches.empty() ) {
+    messagebox::error(L"batchFileNames()");
+    return;
+  }
+
+  for( const NativeString& args : batches ) {
+    launcher.execute(args.data());
+  }
 
   messagebox::information(L"Done! (Batch)");
 }
 
-void parallel_work(WorkContext ctx)
+void parallel_batch_work(WorkContext ctx)
 {
-  if( !window::makeGUIThread() ) {
-    messagebox::error(L"makeGUIThread()");
+  const shell::Launcher launcher(ctx.script.c_str());
+
+  // Spread the files across all threads, unless batches are smaller anyway.
+  const std::size_t numThreads = std::max<std::size_t>(1, ctx.numThreads);
+  const std::size_t perThread  = (ctx.files.size() + numThreads - 1) / numThreads;
+  const std::size_t maxFiles   = ctx.batchSize > 0
+                                 ? std::min(ctx.batchSize, perThread)
+                                 : perThread;
+
+  const NativeStrings batches = batchFileNames(ctx.files, launcher.maxArguments(), maxFiles);
+  if( batches.empty() ) {
+    messagebox::error(L"batchFileNames()");
     return;
   }
 
-  ProgressBarPtr progress = ProgressBar::make(getInstDLL(), 480, 48);
-  if( !progress ) {
-    messagebox::error(L"ProgressBar::make()");
+  if( !impl_parallel::run(batches.begin(), batches.end(), numThreads, launcher) ) {
     return;
   }
 
-  progress->setPostQuitOnDestroy(true);
-  progress->setRange(0, static_cast<int>(ctx.files.size()));
-  progress->show();
+  messagebox::information(L"Done! (Batch, parallel)");
+}
+
+void parallel_work(WorkContext ctx)
+{
+  // Resolve the script's interpreter once for all files.
+  const shell::Launcher launcher(ctx.script.c_str());
 
-  auto future = conc::mapAsync(ctx.numThreads, ctx.files.begin(), ctx.files.end(),
-                               Worker(ctx.script, progress.get()));
-  message::loop();
-  future.get();
+  if( !impl_parallel::run(ctx.files.begin(), ctx.files.end(), ctx.numThreads, launcher) ) {
+    return;
+  }
 
   messagebox::information(L"Done! (Parallel)");
 }
 
 void sequential_work(WorkContext ctx)
 {
-  const std::wstring exec = ctx.script;
+  const shell::Launcher launcher(ctx.script.c_str());
   for( const std::filesystem::path& path : ctx.files ) {
     const std::wstring arg = quotedFileName(path);
-    shell::execute(exec.data(), arg.data());
+    launcher.execute(arg.data());
   }
 
   messagebox::information(L"Done! (Sequential)");
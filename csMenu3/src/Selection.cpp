@@ -0,0 +1,340 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+
+#include "Selection.h"
+
+#include "ParallelSort.h"
+#include "SortKey.h"
+#include "ThreadPool.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_selection {
+
+  constexpr std::size_t NPOS = std::wstring_view::npos;
+
+  // Compute the keys of at least this many names per thread...
+  constexpr std::size_t MIN_KEY_CHUNK = 4096;
+
+  constexpr wchar_t SEP = std::filesystem::path::preferred_separator;
+
+  constexpr std::wstring_view SEPARATORS(L"\\/");
+
+  inline bool isSeparator(const wchar_t ch)
+  {
+    return SEPARATORS.find(ch) != NPOS;
+  }
+
+  // "C:\dir\file" -> {"C:\dir", "file"}, "C:\file" -> {"C:\", "file"}, "C:\" -> {"C:\", ""}
+  void split(const std::wstring_view& filename, std::wstring_view& parent, std::wstring_view& name)
+  {
+    const std::size_t pos = filename.find_last_of(SEPARATORS);
+    if( pos == NPOS || pos + 1 == filename.size() ) {
+      parent = filename;
+      name   = std::wstring_view{};
+      return;
+    }
+
+    parent = filename.substr(0, pos);
+    name   = filename.substr(pos + 1);
+
+    if( parent.empty() || parent.back() == L':' || parent.find_first_not_of(SEPARATORS) == NPOS ) {
+      parent = filename.substr(0, pos + 1); // Root
+    }
+  }
+
+} // namespace impl_selection
+
+////// public ////////////////////////////////////////////////////////////////
+
+std::wstring Selection::Item::filename() const
+{
+  if( name.empty() ) {
+    return std::wstring{parent};
+  }
+
+  const bool is_sep = !parent.empty() && !impl_selection::isSeparator(parent.back());
+
+  std::wstring result;
+  result.reserve(parent.size() + (is_sep ? 1 : 0) + name.size());
+  result.append(parent);
+  if( is_sep ) {
+    result.push_back(impl_selection::SEP);
+  }
+  result.append(name);
+
+  return result;
+}
+
+std::filesystem::path Selection::Item::path() const
+{
+  return std::filesystem::path{filename()};
+}
+
+Selection::Selection() noexcept
+{
+}
+
+Selection::~Selection() noexcept
+{
+}
+
+bool Selection::empty() const
+{
+  return _entries.empty();
+}
+
+std::size_t Selection::size() const
+{
+  return _entries.size();
+}
+
+std::size_t Selection::numParents() const
+{
+  return _parents.size();
+}
+
+std::wstring_view Selection::parent(const std::size_t parentId) const
+{
+  return view(_parents[parentId]);
+}
+
+Selection::Item Selection::operator[](const std::size_t index) const
+{
+  const Entry& entry = _entries[index];
+  return Item{entry.parentId, view(_parents[entry.parentId]), view(entry.name)};
+}
+
+Selection::const_iterator Selection::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+Selection::const_iterator Selection::end() const
+{
+  return const_iterator(this, _entries.size());
+}
+
+void Selection::append(const std::wstring_view& filename)
+{
+  std::wstring_view parent, name;
+  impl_selection::split(filename, parent, name);
+
+  Entry entry;
+  entry.parentId = intern(parent);
+  entry.name     = store(name);
+
+  _entries.push_back(entry);
+}
+
+/*
+ * NOTE: Items are sorted by their parent first, then by their name; both in
+ *       natural order (cf. SortKey.h). All keys are computed once up front.
+ */
+
+void Selection::sort()
+{
+  // (1) Rank Parents ////////////////////////////////////////////////////////
+
+  std::vector<std::wstring> parentKeys;
+  parentKeys.reserve(_parents.size());
+  for( const Span& parent : _parents ) {
+    parentKeys.push_back(makeSortKey(view(parent)));
+  }
+
+  std::vector<uint32_t> order(_parents.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](const uint32_t a, const uint32_t b) -> bool {
+              const int cmp = parentKeys[a].compare(parentKeys[b]);
+              return cmp != 0
+                     ? cmp < 0
+                     : view(_parents[a]) < view(_parents[b]);
+            });
+
+  std::vector<uint32_t> ranks(_parents.size());
+  for( std::size_t i = 0; i < order.size(); i++ ) {
+    ranks[order[i]] = static_cast<uint32_t>(i);
+  }
+
+  // (2) Keys of Names ///////////////////////////////////////////////////////
+
+  /*
+   * NOTE: Names of one folder tend to share a prefix (e.g. "IMG_"). Hence,
+   *       the key's first characters after the common prefix are packed
+   *       into each Sortable; most comparisons never touch the keys' arena.
+   */
+
+  struct Sortable {
+    uint64_t prefix[2]{0, 0};
+    uint32_t rank{0};
+    uint32_t index{0};
+  };
+
+  // NOTE: Keys come from the OS' collation; hence, they are computed in
+  //       parallel chunks, which are then concatenated.
+
+  const std::size_t numEntries = _entries.size();
+  const std::size_t numChunks  = std::max<std::size_t>(1, std::min(ThreadPool::instance().budget(),
+                                                                   numEntries / impl_selection::MIN_KEY_CHUNK));
+
+  std::vector<std::wstring> chunks(numChunks);
+  std::vector<Span> spans(numEntries);
+  ThreadPool::instance().forEach(numChunks, numChunks, [&](const std::size_t c) -> void {
+    std::wstring& chunk = chunks[c];
+    chunk.reserve(_arena.size() / numChunks);
+
+    for( std::size_t i = c * numEntries / numChunks; i < (c + 1) * numEntries / numChunks; i++ ) {
+      spans[i].offset = static_cast<uint32_t>(chunk.size());
+      appendSortKey(chunk, view(_entries[i].name));
+      spans[i].length = static_cast<uint32_t>(chunk.size()) - spans[i].offset;
+    }
+  });
+
+  std::wstring keys;
+  for( std::size_t c = 0; c < numChunks; c++ ) {
+    const uint32_t base = static_cast<uint32_t>(keys.size());
+    for( std::size_t i = c * numEntries / numChunks; i < (c + 1) * numEntries / numChunks; i++ ) {
+      spans[i].offset += base;
+    }
+
+    keys.append(chunks[c]);
+    chunks[c] = std::wstring{};
+  }
+
+  const std::wstring_view keyView(keys);
+
+  std::size_t common = !spans.empty()
+                       ? spans.front().length
+                       : 0;
+  for( const Span& span : spans ) {
+    const std::wstring_view a = keyView.substr(spans.front().offset, common);
+    const std::wstring_view b = keyView.substr(span.offset, span.length);
+    common = std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first - a.begin();
+  }
+
+  std::vector<Sortable> sortables(_entries.size());
+  for( std::size_t index = 0; index < sortables.size(); index++ ) {
+    Sortable& s = sortables[index];
+    s.rank      = ranks[_entries[index].parentId];
+    s.index     = static_cast<uint32_t>(index);
+
+    const std::wstring_view key = keyView.substr(spans[index].offset, spans[index].length);
+    for( std::size_t i = 0; i < 8; i++ ) {
+      const std::size_t pos = common + i;
+      const uint64_t ch     = pos < key.size()
+                              ? std::min<uint64_t>(key[pos], 0xFFFF) // Monotonic
+                              : 0;
+      s.prefix[i / 4] |= ch << (48 - 16 * (i % 4));
+    }
+  }
+
+  // (3) Sort ////////////////////////////////////////////////////////////////
+
+  parallelSort(sortables.begin(), sortables.end(),
+               [&](const Sortable& a, const Sortable& b) -> bool {
+                 if( a.rank != b.rank ) {
+                   return a.rank < b.rank;
+                 } else if( a.prefix[0] != b.prefix[0] ) {
+                   return a.prefix[0] < b.prefix[0];
+                 } else if( a.prefix[1] != b.prefix[1] ) {
+                   return a.prefix[1] < b.prefix[1];
+                 }
+
+                 const Span& keyA = spans[a.index];
+                 const Span& keyB = spans[b.index];
+                 const int cmp    = keyView.substr(keyA.offset, keyA.length)
+                                     .compare(keyView.substr(keyB.offset, keyB.length));
+                 return cmp != 0
+                        ? cmp < 0
+                        : view(_entries[a.index].name) < view(_entries[b.index].name);
+               },
+               ThreadPool::instance().budget());
+
+  std::vector<Entry> sorted;
+  sorted.reserve(_entries.size());
+  for( const Sortable& s : sortables ) {
+    sorted.push_back(_entries[s.index]);
+  }
+  _entries = std::move(sorted);
+}
+
+cs::PathList Selection::paths() const
+{
+  cs::PathList result;
+  for( const Item& item : *this ) {
+    result.push_back(item.path());
+  }
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+std::wstring_view Selection::view(const Span& span) const
+{
+  return std::wstring_view(_arena).substr(span.offset, span.length);
+}
+
+Selection::Span Selection::store(const std::wstring_view& str)
+{
+  Span result;
+  result.offset = static_cast<uint32_t>(_arena.size());
+  result.length = static_cast<uint32_t>(str.size());
+
+  _arena.append(str);
+
+  return result;
+}
+
+uint32_t Selection::intern(const std::wstring_view& parent)
+{
+  // Fast path: Same parent as the previous item...
+  if( !_entries.empty() && view(_parents[_entries.back().parentId]) == parent ) {
+    return _entries.back().parentId;
+  }
+
+  const std::wstring key{parent};
+
+  const auto hit = _parentIds.find(key);
+  if( hit != _parentIds.end() ) {
+    return hit->second;
+  }
+
+  const uint32_t result = static_cast<uint32_t>(_parents.size());
+  _parents.push_back(store(parent));
+  _parentIds.emplace(key, result);
+
+  return result;
+}
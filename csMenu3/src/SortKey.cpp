@@ -0,0 +1,86 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "SortKey.h"
+
+#include "Win32/String.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_sortkey {
+
+  constexpr wchar_t KEY_SEPARATOR = L'\x01'; // Below any character of a component's key
+
+  inline bool isSeparator(const wchar_t ch)
+  {
+    return ch == L'\\' || ch == L'/';
+  }
+
+  void appendComponent(std::wstring& key, const std::wstring_view& component)
+  {
+    if( !StringSortKey(key, component.data(), component.size()) ) {
+      key.append(component); // Ordinal order, as a last resort
+    }
+  }
+
+} // namespace impl_sortkey
+
+////// Public ////////////////////////////////////////////////////////////////
+
+/*
+ * NOTE: Each path component is keyed by the OS' collation of the user's
+ *       locale, with digits as numbers & ignoring case; cf. StrCmpLogicalW(),
+ *       i.e. Explorer. Components are joined by KEY_SEPARATOR.
+ */
+
+void appendSortKey(std::wstring& key, const std::wstring_view& name)
+{
+  using namespace impl_sortkey;
+
+  std::size_t first = 0;
+  for( std::size_t i = 0; i < name.size(); i++ ) {
+    if( isSeparator(name[i]) ) {
+      appendComponent(key, name.substr(first, i - first));
+      key.push_back(KEY_SEPARATOR);
+      first = i + 1;
+    }
+  }
+  appendComponent(key, name.substr(first));
+}
+
+std::wstring makeSortKey(const std::wstring_view& name)
+{
+  std::wstring result;
+  result.reserve(name.size() + 4);
+  appendSortKey(result, name);
+
+  return result;
+}
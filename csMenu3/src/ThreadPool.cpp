@@ -0,0 +1,333 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+
+#include "ThreadPool.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_threadpool {
+
+  constexpr std::chrono::seconds IDLE_TIMEOUT{10};
+
+  constexpr std::size_t NO_WORKER = std::size_t(-1);
+
+  // Worker of the current thread, if any.
+  thread_local const ThreadPool *t_pool = nullptr;
+  thread_local std::size_t t_self       = NO_WORKER;
+
+} // namespace impl_threadpool
+
+////// public ////////////////////////////////////////////////////////////////
+
+ThreadPool& ThreadPool::instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+  // NOTE: Destroyed while the DLL is unloaded, i.e. under the loader lock;
+  //       joining would deadlock. Threads left are terminated already.
+  for( Thread& worker : _workers ) {
+    if( worker.thread.joinable() ) {
+      worker.thread.detach();
+    }
+  }
+  for( Thread& job : _jobs ) {
+    if( job.thread.joinable() ) {
+      job.thread.detach();
+    }
+  }
+}
+
+std::size_t ThreadPool::budget() const
+{
+  return _budget;
+}
+
+bool ThreadPool::launch(Task job)
+{
+  if( !job ) {
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  reapJobs();
+
+  try {
+    Thread& thread = _jobs.emplace_back();
+    thread.thread  = std::thread([this, &thread, job = std::move(job)]() -> void {
+      try {
+        job();
+      } catch( ... ) {
+      }
+
+      const std::lock_guard<std::mutex> lock(_mutex);
+      thread.isExited = true;
+    });
+  } catch( ... ) {
+    if( !_jobs.empty() && !_jobs.back().thread.joinable() ) {
+      _jobs.pop_back();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool ThreadPool::submit(Task task)
+{
+  using namespace impl_threadpool;
+
+  if( !task ) {
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  const bool is_idle = _numIdle > _numWakeups;
+  if( !is_idle && _numRunning < _budget ) {
+    startWorker();
+  }
+
+  if( _numRunning == 0 ) {
+    return false;
+  }
+
+  const std::size_t self = t_pool == this
+                           ? t_self
+                           : _next++ % _budget;
+  try {
+    push(self, std::move(task));
+  } catch( ... ) {
+    return false;
+  }
+
+  if( is_idle ) {
+    _numWakeups++;
+    _work.notify_one();
+  }
+
+  return true;
+}
+
+bool ThreadPool::release()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  reapJobs();
+  if( !_jobs.empty() || _numPending > 0 || _numRunning > _numIdle ) {
+    return false;
+  }
+
+  // (1) Stop Workers ////////////////////////////////////////////////////////
+
+  _isStopping = true;
+  _work.notify_all();
+  lock.unlock();
+
+  for( Thread& worker : _workers ) {
+    if( worker.thread.joinable() ) {
+      worker.thread.join();
+    }
+  }
+
+  // (2) Resume; Tasks might have been Queued Meanwhile //////////////////////
+
+  lock.lock();
+  for( Thread& worker : _workers ) {
+    worker.isExited = false;
+  }
+  _numWakeups = 0;
+  _isStopping = false;
+
+  if( _numPending > 0 ) {
+    startWorker();
+  }
+
+  return _numRunning == 0;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool() noexcept
+{
+  try {
+    _budget = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+    for( std::size_t i = 0; i < _budget; i++ ) {
+      _queues.push_back(std::make_unique<Queue>());
+    }
+    _workers.resize(_budget);
+  } catch( ... ) {
+    _budget = 0;
+    _queues.clear();
+    _workers.clear();
+  }
+}
+
+ThreadPool::Task ThreadPool::pop(const std::size_t self)
+{
+  // (1) Own Work; Newest First //////////////////////////////////////////////
+
+  {
+    Queue& own = *_queues[self];
+
+    const std::lock_guard<std::mutex> lock(own.mutex);
+    if( !own.tasks.empty() ) {
+      Task task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      _numPending--;
+      return task;
+    }
+  }
+
+  // (2) Steal Other's Work; Oldest First ////////////////////////////////////
+
+  const std::size_t numQueues = _queues.size();
+  for( std::size_t i = 1; i < numQueues; i++ ) {
+    Queue& victim = *_queues[(self + i) % numQueues];
+
+    const std::lock_guard<std::mutex> lock(victim.mutex);
+    if( !victim.tasks.empty() ) {
+      Task task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      _numPending--;
+      return task;
+    }
+  }
+
+  return Task{};
+}
+
+void ThreadPool::push(const std::size_t self, Task&& task)
+{
+  Queue& queue = *_queues[self];
+
+  const std::lock_guard<std::mutex> lock(queue.mutex);
+  _numPending++;
+  try {
+    queue.tasks.push_back(std::move(task));
+  } catch( ... ) {
+    _numPending--;
+    throw;
+  }
+}
+
+void ThreadPool::reapJobs()
+{
+  for( auto it = _jobs.begin(); it != _jobs.end(); ) {
+    if( it->isExited ) {
+      it->thread.join();
+      it = _jobs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ThreadPool::run(const std::size_t self)
+{
+  using namespace impl_threadpool;
+
+  t_pool = this;
+  t_self = self;
+
+  std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+  while( true ) {
+    Task task = pop(self);
+    if( task ) {
+      try {
+        task();
+      } catch( ... ) {
+      }
+      continue;
+    }
+
+    lock.lock();
+    if( _numPending > 0 ) { // Queued, but not yet visible to pop()
+      lock.unlock();
+      continue;
+    }
+    if( _isStopping ) {
+      break;
+    }
+
+    _numIdle++;
+    const bool is_woken = _work.wait_for(lock, IDLE_TIMEOUT, [this]() -> bool {
+      return _numWakeups > 0 || _isStopping;
+    });
+    _numIdle--;
+
+    if( !is_woken || _isStopping ) {
+      break;
+    }
+    _numWakeups--;
+    lock.unlock();
+  }
+
+  // NOTE: Joined by startWorker() or release(); cf. _mutex.
+  _numRunning--;
+  _workers[self].isExited = true;
+}
+
+bool ThreadPool::startWorker()
+{
+  if( _isStopping ) {
+    return false;
+  }
+
+  for( std::size_t i = 0; i < _workers.size(); i++ ) {
+    Thread& worker = _workers[i];
+    if( worker.thread.joinable() ) {
+      if( !worker.isExited ) {
+        continue;
+      }
+      worker.thread.join();
+    }
+
+    try {
+      worker.isExited = false;
+      worker.thread   = std::thread(&ThreadPool::run, this, i);
+    } catch( ... ) {
+      return false;
+    }
+
+    _numRunning++;
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,316 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <format>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "TuneWorker.h"
+
+#include "ThreadPool.h"
+#include "Util.h"
+#include "VolumeSettings.h"
+#include "Win32/Message.h"
+#include "Win32/MessageBox.h"
+#include "Win32/ProgressBar.h"
+#include "Win32/Volume.h"
+#include "Win32/WindowUtil.h"
+
+////// Imports ///////////////////////////////////////////////////////////////
+
+extern HANDLE_t getInstDLL(); // main.cpp
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_tune {
+
+  namespace fs = std::filesystem;
+
+  using Clock = std::chrono::steady_clock;
+
+  constexpr std::size_t KiB = 1024;
+  constexpr std::size_t MiB = 1024 * KiB;
+
+  constexpr std::size_t MAX_THREADS = 16;
+
+  // NOTE: Digests are computed with their readers' own block sizes; hence,
+  //       only the number of threads is calibrated.
+  constexpr std::size_t TRIAL_BLOCK_SIZE = 1 * MiB;
+
+  // Smaller files do not sustain sequential reads; their rates are noise...
+  constexpr uint64_t MIN_SAMPLE_SIZE = 8 * MiB;
+
+  constexpr std::size_t MAX_SAMPLES = 16;
+  constexpr uint64_t TRIAL_BYTES    = 32 * MiB;
+
+  // Only switch to a more demanding configuration if it is clearly faster.
+  constexpr double MIN_GAIN = 1.05;
+
+  struct Sample {
+    fs::path filename{};
+    uint64_t size{0};
+  };
+
+  using Samples = std::vector<Sample>;
+
+  using Volumes = std::map<std::wstring, Samples>;
+
+  struct Result {
+    VolumeSettings settings{};
+    double rate{0}; // [Bytes/s]
+  };
+
+  /*
+   * NOTE: Hashing reads a volume on at most ThreadPool::budget() workers
+   *       (cf. ThreadPool::mapReduceAsync()); hence, no more threads are
+   *       tried. The trials are the powers of two below the budget & the
+   *       budget itself.
+   */
+
+  std::vector<std::size_t> threadCounts()
+  {
+    const std::size_t maxThreads = std::min<std::size_t>(ThreadPool::instance().budget(), MAX_THREADS);
+
+    std::vector<std::size_t> result;
+    for( std::size_t n = 1; n < maxThreads; n *= 2 ) {
+      result.push_back(n);
+    }
+    result.push_back(maxThreads);
+
+    return result;
+  }
+
+  Volumes groupByVolume(const WorkContext& ctx)
+  {
+    Volumes result;
+
+    try {
+      for( const fs::path& filename : ctx.files ) {
+        const std::wstring volumeId = volume::identifier(filename.c_str());
+        if( volumeId.empty() ) {
+          continue;
+        }
+
+        // NOTE: Volumes w/o samples are reported as skipped.
+        Samples& samples = result[volumeId];
+
+        const uint64_t size = ctx.size(filename);
+        if( size >= MIN_SAMPLE_SIZE ) {
+          samples.push_back(Sample{filename, size});
+        }
+      } // For Each File
+
+      // Largest files first; they sustain sequential reads the longest...
+
+      for( auto& [volumeId, samples] : result ) {
+        std::sort(samples.begin(), samples.end(),
+                  [](const Sample& a, const Sample& b) -> bool {
+                    return a.size > b.size;
+                  });
+        if( samples.size() > MAX_SAMPLES ) {
+          samples.resize(MAX_SAMPLES);
+        }
+      }
+    } catch( ... ) {
+      return Volumes{};
+    }
+
+    return result;
+  }
+
+  /*
+   * NOTE: Each thread sequentially reads its own sample; if there are fewer
+   *       samples than threads, threads share a sample at distinct offsets.
+   *       The readers are jobs of the ThreadPool, i.e. exactly numThreads
+   *       run concurrently, regardless of the pool's budget.
+   */
+
+  double measure(const Samples& samples, const std::size_t numThreads)
+  {
+    struct State {
+      std::atomic<uint64_t> numTotal{0};
+      std::size_t numDone{0};
+      std::mutex mutex;
+      std::condition_variable done;
+    };
+
+    const uint64_t perThread = TRIAL_BYTES / numThreads;
+
+    const std::shared_ptr<State> state = std::make_shared<State>();
+    std::size_t numLaunched            = 0;
+
+    const Clock::time_point start = Clock::now();
+    for( std::size_t i = 0; i < numThreads; i++ ) {
+      const Sample& sample  = samples[i % samples.size()];
+      const uint64_t offset = (i / samples.size()) * perThread % sample.size;
+
+      const bool ok = ThreadPool::instance().launch([state, &sample, offset, perThread]() -> void {
+        state->numTotal += volume::readUncached(sample.filename.c_str(), offset, TRIAL_BLOCK_SIZE, perThread);
+
+        const std::lock_guard<std::mutex> lock(state->mutex);
+        state->numDone++;
+        state->done.notify_all();
+      });
+      if( !ok ) {
+        break; // Measure what is running...
+      }
+      numLaunched++;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.wait(lock, [&]() -> bool {
+        return state->numDone == numLaunched;
+      });
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    if( numLaunched != numThreads || elapsed.count() <= 0 ) {
+      return 0;
+    }
+
+    return static_cast<double>(state->numTotal) / elapsed.count();
+  }
+
+  Result calibrate(const Samples& samples, const ProgressBar *progress)
+  {
+    Result best;
+
+    for( const std::size_t numThreads : threadCounts() ) {
+      const double rate = measure(samples, numThreads);
+      if( rate > best.rate * MIN_GAIN ) {
+        best.settings = VolumeSettings{numThreads};
+        best.rate     = rate;
+      }
+
+      if( progress != nullptr ) {
+        progress->step();
+      }
+    } // For Each Thread Count
+
+    return best;
+  }
+
+  std::wstring calibrateAll(const Volumes& volumes, const ProgressBar *progress)
+  {
+    std::wstring summary;
+
+    for( const auto& [volumeId, samples] : volumes ) {
+      if( samples.empty() ) {
+        try {
+          summary += std::format(L"Volume {}: Skipped; no file of at least {} MiB",
+                                 volumeId, MIN_SAMPLE_SIZE / MiB);
+          summary += EOL;
+        } catch( ... ) {
+        }
+        continue;
+      }
+
+      const Result result = calibrate(samples, progress);
+      const bool ok       = writeVolumeSettings(volumeId, result.settings);
+
+      try {
+        summary += std::format(L"Volume {}: {} thread(s), {:.0f} MB/s{}",
+                               volumeId, result.settings.numThreads, result.rate / 1e6,
+                               ok ? L"" : L" (not saved!)");
+        summary += EOL;
+      } catch( ... ) {
+      }
+    } // For Each Volume
+
+    if( progress != nullptr ) {
+      progress->close();
+    }
+
+    return summary;
+  }
+
+} // namespace impl_tune
+
+////// Public ////////////////////////////////////////////////////////////////
+
+void calibrate_work(WorkContext ctx)
+{
+  const impl_tune::Volumes volumes = impl_tune::groupByVolume(ctx);
+
+  const std::size_t numCalibrated = std::count_if(volumes.begin(), volumes.end(),
+                                                  [](const auto& volume) -> bool {
+                                                    return !volume.second.empty();
+                                                  });
+  if( numCalibrated < 1 ) {
+    messagebox::warning(std::format(L"No readable files of at least {} MiB to calibrate!",
+                                    impl_tune::MIN_SAMPLE_SIZE / impl_tune::MiB).data());
+    return;
+  }
+
+  if( !window::makeGUIThread() ) {
+    messagebox::error(L"makeGUIThread()");
+    return;
+  }
+
+  ProgressBarPtr progress = ProgressBar::make(getInstDLL(), 480, 48);
+  if( !progress ) {
+    messagebox::error(L"ProgressBar::make()");
+    return;
+  }
+
+  progress->setPostQuitOnDestroy(true);
+  progress->setRange(0, static_cast<int>(numCalibrated * impl_tune::threadCounts().size()));
+  progress->show();
+
+  // NOTE: Volumes are calibrated one after another, on a job of its own.
+  const auto promise = std::make_shared<std::promise<std::wstring>>();
+  auto future        = promise->get_future();
+
+  const bool ok = ThreadPool::instance().launch([promise, &volumes, p = progress.get()]() -> void {
+    try {
+      promise->set_value(impl_tune::calibrateAll(volumes, p));
+    } catch( ... ) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+  if( !ok ) {
+    messagebox::error(L"ThreadPool::launch()");
+    return;
+  }
+
+  message::loop();
+  const std::wstring summary = future.get();
+
+  messagebox::information(summary.data(), L"Calibrate storage");
+}
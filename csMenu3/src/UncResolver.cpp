@@ -0,0 +1,214 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cwctype>
+
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "UncResolver.h"
+
+#include "ThreadPool.h"
+#include "Win32/Network.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_unc {
+
+  using Clock = std::chrono::steady_clock;
+
+  using Future = std::shared_future<std::wstring>;
+
+  struct Entry {
+    Future root{};
+    Clock::time_point stamp{};
+  };
+
+  struct Cache {
+    std::mutex mutex{};
+    std::unordered_map<wchar_t, Entry> entries{};
+  };
+
+  Cache& cache()
+  {
+    static Cache instance;
+    return instance;
+  }
+
+  // Returns the upper-case drive letter of "X:..."; 0 otherwise.
+  wchar_t driveOf(const std::wstring_view& filename)
+  {
+    if( filename.size() < 2 || filename[1] != L':' || !std::iswalpha(filename[0]) ) {
+      return 0;
+    }
+    return static_cast<wchar_t>(std::towupper(filename[0]));
+  }
+
+  std::wstring resolveRoot(const wchar_t drive)
+  {
+    const wchar_t root[] = {drive, L':', L'\\', L'\0'};
+
+    std::wstring result = resolveUniversalName(root);
+    while( !result.empty() && result.back() == L'\\' ) {
+      result.pop_back();
+    }
+
+    return result;
+  }
+
+  bool isReady(const Future& future)
+  {
+    return future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+  }
+
+  Future lookup(const wchar_t drive)
+  {
+    const Clock::time_point now = Clock::now();
+
+    Cache& c = cache();
+    const std::lock_guard<std::mutex> lock(c.mutex);
+
+    const auto hit = c.entries.find(drive);
+    if( hit != c.entries.end() &&
+        (!isReady(hit->second.root) || now - hit->second.stamp < UncResolver::CACHE_LIFETIME) ) {
+      return hit->second.root;
+    }
+
+    const auto promise = std::make_shared<std::promise<std::wstring>>();
+    Future result      = promise->get_future().share();
+
+    const auto lambda_lookup = [drive, promise]() -> void {
+      try {
+        promise->set_value(resolveRoot(drive));
+      } catch( ... ) {
+        promise->set_exception(std::current_exception());
+      }
+    };
+
+    // NOTE: The lookup is a job of its own; it may outlive the invocation's
+    //       timeout, but not the DLL; cf. ThreadPool::release().
+    if( !ThreadPool::instance().launch(lambda_lookup) ) {
+      promise->set_value(std::wstring{});
+    }
+
+    c.entries.insert_or_assign(drive, Entry{result, now});
+
+    return result;
+  }
+
+} // namespace impl_unc
+
+////// public ////////////////////////////////////////////////////////////////
+
+UncResolver::UncResolver(const cs::PathList& selection,
+                         const std::chrono::milliseconds timeout) noexcept
+{
+  try {
+    Drives drives;
+    for( const std::filesystem::path& filename : selection ) {
+      drives.push_back(impl_unc::driveOf(filename.wstring()));
+    }
+
+    lookup(drives, timeout);
+  } catch( ... ) {
+    _roots.clear();
+  }
+}
+
+UncResolver::UncResolver(const Selection& selection,
+                         const std::chrono::milliseconds timeout) noexcept
+{
+  try {
+    Drives drives;
+    for( std::size_t parentId = 0; parentId < selection.numParents(); parentId++ ) {
+      drives.push_back(impl_unc::driveOf(selection.parent(parentId)));
+    }
+
+    lookup(drives, timeout);
+  } catch( ... ) {
+    _roots.clear();
+  }
+}
+
+UncResolver::~UncResolver() noexcept
+{
+}
+
+std::wstring UncResolver::resolve(std::wstring filename) const
+{
+  const auto hit = _roots.find(impl_unc::driveOf(filename));
+  if( hit == _roots.cend() ) {
+    return filename;
+  }
+
+  // "X:\dir\file" -> "\\server\share" + "\dir\file"
+  return hit->second + filename.substr(2);
+}
+
+void UncResolver::invalidate()
+{
+  impl_unc::Cache& c = impl_unc::cache();
+
+  const std::lock_guard<std::mutex> lock(c.mutex);
+  c.entries.clear();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void UncResolver::lookup(const Drives& drives, const std::chrono::milliseconds timeout)
+{
+  using namespace impl_unc;
+
+  const Clock::time_point deadline = Clock::now() + timeout;
+
+  // (1) Start Lookups of all Drives /////////////////////////////////////////
+
+  std::unordered_map<wchar_t, Future> lookups;
+  for( const wchar_t drive : drives ) {
+    if( drive != 0 && !lookups.contains(drive) ) {
+      lookups.emplace(drive, impl_unc::lookup(drive));
+    }
+  }
+
+  // (2) Collect Lookups Finished in Time ////////////////////////////////////
+
+  for( const auto& [drive, future] : lookups ) {
+    if( future.wait_until(deadline) != std::future_status::ready ) {
+      continue;
+    }
+
+    std::wstring root = future.get();
+    if( !root.empty() ) {
+      _roots.emplace(drive, std::move(root));
+    }
+  }
+}
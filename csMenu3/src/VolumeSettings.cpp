@@ -0,0 +1,100 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "VolumeSettings.h"
+
+#include "Settings.h"
+#include "Win32/Registry.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_volume {
+
+  std::wstring makeKey(const std::wstring& volumeId)
+  {
+    std::wstring key;
+    try {
+      key  = KEY_VOLUMES;
+      key += L'\\';
+      key += volumeId;
+    } catch( ... ) {
+      key.clear();
+    }
+
+    return key;
+  }
+
+} // namespace impl_volume
+
+////// public ////////////////////////////////////////////////////////////////
+
+VolumeSettings::VolumeSettings(const std::size_t numThreads) noexcept
+  : numThreads{numThreads}
+{
+}
+
+bool VolumeSettings::isValid() const
+{
+  return numThreads > 0;
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+VolumeSettings readVolumeSettings(const std::wstring& volumeId)
+{
+  if( volumeId.empty() ) {
+    return VolumeSettings{};
+  }
+
+  const std::wstring key = impl_volume::makeKey(volumeId);
+  if( key.empty() ) {
+    return VolumeSettings{};
+  }
+
+  VolumeSettings result;
+  result.numThreads = reg::readCurrentUserDWord(key.data(), NAME_PARALLEL_COUNT);
+
+  return result;
+}
+
+bool writeVolumeSettings(const std::wstring& volumeId, const VolumeSettings& settings)
+{
+  if( volumeId.empty() || !settings.isValid() ) {
+    return false;
+  }
+
+  const std::wstring key = impl_volume::makeKey(volumeId);
+  if( key.empty() ) {
+    return false;
+  }
+
+  return reg::writeCurrentUserDWord(key.data(), NAME_PARALLEL_COUNT, static_cast<DWORD_t>(settings.numThreads));
+}
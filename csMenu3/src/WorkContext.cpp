@@ -30,22 +30,27 @@
 *****************************************************************************/
 
 #include <algorithm>
+#include <iterator>
+#include <unordered_map>
 
 #include "WorkContext.h"
 
 #include "Settings.h"
+#include "VolumeSettings.h"
 #include "Win32/Registry.h"
+#include "Win32/Volume.h"
 
 ////// public ////////////////////////////////////////////////////////////////
 
 WorkContext::WorkContext() noexcept
 {
   numThreads = std::max<std::size_t>(1, reg::readCurrentUserDWord(KEY_CSMENU, NAME_PARALLEL_COUNT));
+  batchSize  = reg::readCurrentUserDWord(KEY_CSMENU, NAME_BATCH_SIZE);
 }
 
 bool WorkContext::isEmpty() const
 {
-  return !cs::isFile(script) || files.empty();
+  return !isFile(script) || files.empty();
 }
 
 bool WorkContext::setScript(const std::wstring& filename)
@@ -53,12 +58,73 @@ bool WorkContext::setScript(const std::wstring& filename)
   script  = reg::readCurrentUserString(KEY_CSMENU, NAME_SCRIPTS);
   script /= filename;
 
-  return cs::isFile(script);
+  return isFile(script);
 }
 
 bool WorkContext::setFiles(const cs::PathList& input)
 {
-  files = cs::filter(input, cs::PathListFlag::File);
+  files = snapshot
+          ? snapshot->files(input)
+          : cs::filter(input, cs::PathListFlag::File);
 
   return !files.empty();
 }
+
+WorkVolumes WorkContext::volumes(cs::ConstPathListIter first, cs::ConstPathListIter last) const
+{
+  using Indices = std::unordered_map<std::wstring, std::size_t>;
+
+  WorkVolumes result;
+  try {
+    // NOTE: Selected files share few directories; query each one's volume once.
+    Indices byDirectory; // Directory -> Volume
+    Indices byVolume;    // Volume ID -> Volume
+
+    std::size_t index = static_cast<std::size_t>(std::distance(files.cbegin(), first));
+    for( ; first != last; ++first, ++index ) {
+      const std::wstring directory = first->parent_path().wstring();
+
+      auto hit = byDirectory.find(directory);
+      if( hit == byDirectory.end() ) {
+        const std::wstring volumeId = volume::identifier(first->c_str());
+
+        auto volume = byVolume.find(volumeId);
+        if( volume == byVolume.end() ) {
+          const VolumeSettings tuned = readVolumeSettings(volumeId);
+
+          result.push_back(WorkVolume{std::vector<WorkFile>{}, tuned.isValid()
+                                                               ? tuned.numThreads
+                                                               : numThreads});
+          volume = byVolume.emplace(volumeId, result.size() - 1).first;
+        }
+
+        hit = byDirectory.emplace(directory, volume->second).first;
+      }
+
+      result[hit->second].files.push_back(WorkFile{*first, index});
+    } // For Each File
+  } catch( ... ) {
+    return WorkVolumes{};
+  }
+
+  return result;
+}
+
+bool WorkContext::isFile(const std::filesystem::path& filename) const
+{
+  return snapshot
+         ? snapshot->isFile(filename)
+         : cs::isFile(filename);
+}
+
+uint64_t WorkContext::size(const std::filesystem::path& filename) const
+{
+  if( snapshot ) {
+    return snapshot->size(filename);
+  }
+
+  std::error_code ec;
+  const uint64_t result = std::filesystem::file_size(filename, ec);
+
+  return !ec ? result : 0;
+}
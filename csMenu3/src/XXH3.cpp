@@ -0,0 +1,912 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+# define HAVE_XXH3_X86
+# include <immintrin.h>
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# endif
+#endif
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+# define HAVE_XXH3_NEON
+# include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+# define XXH3_TARGET(isa) __attribute__((target(isa)))
+#else
+# define XXH3_TARGET(isa)
+#endif
+
+#include "XXH3.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_xxh3 {
+
+  // Constants ///////////////////////////////////////////////////////////////
+
+  constexpr std::size_t STRIPE_LEN             = 64;
+  constexpr std::size_t SECRET_CONSUME_RATE    = 8;
+  constexpr std::size_t SECRET_MERGEACCS_START = 11;
+  constexpr std::size_t SECRET_LASTACC_START   = 7;
+  constexpr std::size_t SECRET_SIZE_MIN        = 136;
+  constexpr std::size_t SECRET_SIZE            = 192;
+  constexpr std::size_t MID_SIZE_MAX           = 240;
+
+  constexpr std::size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+
+  constexpr uint32_t PRIME32_1 = 0x9E3779B1;
+  constexpr uint32_t PRIME32_2 = 0x85EBCA77;
+  constexpr uint32_t PRIME32_3 = 0xC2B2AE3D;
+
+  constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87;
+  constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+  constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9;
+  constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63;
+  constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5;
+
+  constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9;
+  constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25;
+
+  alignas(64) constexpr unsigned char SECRET[SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e};
+
+  constexpr uint64_t INIT_ACC[XXH3::NUM_ACC] = {
+    PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+    PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+  // Primitives //////////////////////////////////////////////////////////////
+
+  inline uint32_t swap32(const uint32_t x)
+  {
+    return ((x << 24) & 0xFF000000) | ((x << 8) & 0x00FF0000) |
+           ((x >> 8) & 0x0000FF00) | ((x >> 24) & 0x000000FF);
+  }
+
+  inline uint64_t swap64(const uint64_t x)
+  {
+    return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(x))) << 32) |
+           static_cast<uint64_t>(swap32(static_cast<uint32_t>(x >> 32)));
+  }
+
+  inline uint32_t read32(const unsigned char *ptr)
+  {
+    uint32_t x;
+    std::memcpy(&x, ptr, sizeof(x));
+    if constexpr( std::endian::native == std::endian::big ) {
+      x = swap32(x);
+    }
+    return x;
+  }
+
+  inline uint64_t read64(const unsigned char *ptr)
+  {
+    uint64_t x;
+    std::memcpy(&x, ptr, sizeof(x));
+    if constexpr( std::endian::native == std::endian::big ) {
+      x = swap64(x);
+    }
+    return x;
+  }
+
+  inline XXH3_128 mul128(const uint64_t a, const uint64_t b)
+  {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return XXH3_128{static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+    XXH3_128 result;
+    result.low = _umul128(a, b, &result.high);
+    return result;
+#else
+    const uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    const uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+    const uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+    const uint64_t hi_hi = (a >> 32) * (b >> 32);
+
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+
+    return XXH3_128{(cross << 32) | (lo_lo & 0xFFFFFFFF), hi_hi + (hi_lo >> 32) + (cross >> 32)};
+#endif
+  }
+
+  inline uint64_t mul128_fold64(const uint64_t a, const uint64_t b)
+  {
+    const XXH3_128 product = mul128(a, b);
+    return product.low ^ product.high;
+  }
+
+  inline uint64_t xorshift64(const uint64_t x, const int shift)
+  {
+    return x ^ (x >> shift);
+  }
+
+  inline uint64_t avalanche_xxh64(uint64_t x)
+  {
+    x ^= x >> 33;
+    x *= PRIME64_2;
+    x ^= x >> 29;
+    x *= PRIME64_3;
+    x ^= x >> 32;
+    return x;
+  }
+
+  inline uint64_t avalanche(uint64_t x)
+  {
+    x = xorshift64(x, 37);
+    x *= PRIME_MX1;
+    x = xorshift64(x, 32);
+    return x;
+  }
+
+  inline uint64_t rrmxmx(uint64_t x, const uint64_t len)
+  {
+    x ^= std::rotl(x, 49) ^ std::rotl(x, 24);
+    x *= PRIME_MX2;
+    x ^= (x >> 35) + len;
+    x *= PRIME_MX2;
+    return xorshift64(x, 28);
+  }
+
+  inline uint64_t mix16(const unsigned char *input, const unsigned char *secret)
+  {
+    return mul128_fold64(read64(input) ^ read64(secret),
+                         read64(input + 8) ^ read64(secret + 8));
+  }
+
+  inline void mix32(uint64_t& lo, uint64_t& hi,
+                    const unsigned char *input1, const unsigned char *input2,
+                    const unsigned char *secret)
+  {
+    lo += mix16(input1, secret);
+    lo ^= read64(input2) + read64(input2 + 8);
+    hi += mix16(input2, secret + 16);
+    hi ^= read64(input1) + read64(input1 + 8);
+  }
+
+  uint64_t merge_accs(const uint64_t *acc, const unsigned char *secret, uint64_t result)
+  {
+    for( std::size_t i = 0; i < 4; i++ ) {
+      result += mul128_fold64(acc[2 * i] ^ read64(secret + 16 * i),
+                              acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+    }
+    return avalanche(result);
+  }
+
+  // Kernel: Scalar //////////////////////////////////////////////////////////
+
+  void accumulate_scalar(uint64_t *acc, const unsigned char *input,
+                         const unsigned char *secret, const std::size_t numStripes)
+  {
+    for( std::size_t n = 0; n < numStripes; n++ ) {
+      const unsigned char *in  = input + n * STRIPE_LEN;
+      const unsigned char *key = secret + n * SECRET_CONSUME_RATE;
+
+      for( std::size_t i = 0; i < XXH3::NUM_ACC; i++ ) {
+        const uint64_t data_val = read64(in + 8 * i);
+        const uint64_t data_key = data_val ^ read64(key + 8 * i);
+
+        acc[i ^ 1] += data_val;
+        acc[i]     += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+      }
+    }
+  }
+
+  void scramble_scalar(uint64_t *acc, const unsigned char *secret)
+  {
+    for( std::size_t i = 0; i < XXH3::NUM_ACC; i++ ) {
+      uint64_t x = xorshift64(acc[i], 47);
+      x ^= read64(secret + 8 * i);
+      acc[i] = x * PRIME32_1;
+    }
+  }
+
+#ifdef HAVE_XXH3_X86
+
+  // Kernel: SSE2 ////////////////////////////////////////////////////////////
+
+  XXH3_TARGET("sse2") void accumulate_sse2(uint64_t *acc, const unsigned char *input,
+                                           const unsigned char *secret, const std::size_t numStripes)
+  {
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+
+    for( std::size_t n = 0; n < numStripes; n++ ) {
+      const __m128i *xin  = reinterpret_cast<const __m128i *>(input + n * STRIPE_LEN);
+      const __m128i *xkey = reinterpret_cast<const __m128i *>(secret + n * SECRET_CONSUME_RATE);
+
+      for( std::size_t i = 0; i < 4; i++ ) {
+        const __m128i data_vec    = _mm_loadu_si128(xin + i);
+        const __m128i key_vec     = _mm_loadu_si128(xkey + i);
+        const __m128i data_key    = _mm_xor_si128(data_vec, key_vec);
+        const __m128i data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product     = _mm_mul_epu32(data_key, data_key_lo);
+        const __m128i data_swap   = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m128i sum         = _mm_add_epi64(xacc[i], data_swap);
+        xacc[i]                   = _mm_add_epi64(product, sum);
+      }
+    }
+  }
+
+  XXH3_TARGET("sse2") void scramble_sse2(uint64_t *acc, const unsigned char *secret)
+  {
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+
+    const __m128i *xkey    = reinterpret_cast<const __m128i *>(secret);
+    const __m128i  prime32 = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+
+    for( std::size_t i = 0; i < 4; i++ ) {
+      const __m128i acc_vec     = xacc[i];
+      const __m128i data_vec    = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+      const __m128i data_key    = _mm_xor_si128(data_vec, _mm_loadu_si128(xkey + i));
+      const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      const __m128i prod_lo     = _mm_mul_epu32(data_key, prime32);
+      const __m128i prod_hi     = _mm_mul_epu32(data_key_hi, prime32);
+      xacc[i]                   = _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32));
+    }
+  }
+
+  // Kernel: AVX2 ////////////////////////////////////////////////////////////
+
+  XXH3_TARGET("avx2") void accumulate_avx2(uint64_t *acc, const unsigned char *input,
+                                           const unsigned char *secret, const std::size_t numStripes)
+  {
+    __m256i *xacc = reinterpret_cast<__m256i *>(acc);
+
+    for( std::size_t n = 0; n < numStripes; n++ ) {
+      const __m256i *xin  = reinterpret_cast<const __m256i *>(input + n * STRIPE_LEN);
+      const __m256i *xkey = reinterpret_cast<const __m256i *>(secret + n * SECRET_CONSUME_RATE);
+
+      for( std::size_t i = 0; i < 2; i++ ) {
+        const __m256i data_vec    = _mm256_loadu_si256(xin + i);
+        const __m256i key_vec     = _mm256_loadu_si256(xkey + i);
+        const __m256i data_key    = _mm256_xor_si256(data_vec, key_vec);
+        const __m256i data_key_lo = _mm256_srli_epi64(data_key, 32);
+        const __m256i product     = _mm256_mul_epu32(data_key, data_key_lo);
+        const __m256i data_swap   = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m256i sum         = _mm256_add_epi64(xacc[i], data_swap);
+        xacc[i]                   = _mm256_add_epi64(product, sum);
+      }
+    }
+  }
+
+  XXH3_TARGET("avx2") void scramble_avx2(uint64_t *acc, const unsigned char *secret)
+  {
+    __m256i *xacc = reinterpret_cast<__m256i *>(acc);
+
+    const __m256i *xkey    = reinterpret_cast<const __m256i *>(secret);
+    const __m256i  prime32 = _mm256_set1_epi32(static_cast<int>(PRIME32_1));
+
+    for( std::size_t i = 0; i < 2; i++ ) {
+      const __m256i acc_vec     = xacc[i];
+      const __m256i data_vec    = _mm256_xor_si256(acc_vec, _mm256_srli_epi64(acc_vec, 47));
+      const __m256i data_key    = _mm256_xor_si256(data_vec, _mm256_loadu_si256(xkey + i));
+      const __m256i data_key_hi = _mm256_srli_epi64(data_key, 32);
+      const __m256i prod_lo     = _mm256_mul_epu32(data_key, prime32);
+      const __m256i prod_hi     = _mm256_mul_epu32(data_key_hi, prime32);
+      xacc[i]                   = _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32));
+    }
+  }
+
+  // CPU Features ////////////////////////////////////////////////////////////
+
+  bool hasSSE2()
+  {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true; // Baseline of x86-64
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") != 0;
+#endif
+  }
+
+  bool hasAVX2()
+  {
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    if( info[0] < 7 ) {
+      return false;
+    }
+
+    // The OS must save the YMM registers on context switches...
+    __cpuid(info, 1);
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx     = (info[2] & (1 << 28)) != 0;
+    if( !has_osxsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6 ) {
+      return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+  }
+
+#endif // HAVE_XXH3_X86
+
+#ifdef HAVE_XXH3_NEON
+
+  // Kernel: NEON ////////////////////////////////////////////////////////////
+
+  void accumulate_neon(uint64_t *acc, const unsigned char *input,
+                       const unsigned char *secret, const std::size_t numStripes)
+  {
+    uint64x2_t xacc[4];
+    for( std::size_t i = 0; i < 4; i++ ) {
+      xacc[i] = vld1q_u64(acc + 2 * i);
+    }
+
+    for( std::size_t n = 0; n < numStripes; n++ ) {
+      const unsigned char *in  = input + n * STRIPE_LEN;
+      const unsigned char *key = secret + n * SECRET_CONSUME_RATE;
+
+      for( std::size_t i = 0; i < 4; i++ ) {
+        const uint64x2_t data_vec    = vreinterpretq_u64_u8(vld1q_u8(in + 16 * i));
+        const uint64x2_t key_vec     = vreinterpretq_u64_u8(vld1q_u8(key + 16 * i));
+        const uint64x2_t data_key    = veorq_u64(data_vec, key_vec);
+        const uint32x2_t data_key_lo = vmovn_u64(data_key);
+        const uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+        const uint64x2_t data_swap   = vextq_u64(data_vec, data_vec, 1);
+        xacc[i]                      = vaddq_u64(xacc[i], vmlal_u32(data_swap, data_key_lo, data_key_hi));
+      }
+    }
+
+    for( std::size_t i = 0; i < 4; i++ ) {
+      vst1q_u64(acc + 2 * i, xacc[i]);
+    }
+  }
+
+  void scramble_neon(uint64_t *acc, const unsigned char *secret)
+  {
+    const uint32x2_t prime32 = vdup_n_u32(PRIME32_1);
+
+    for( std::size_t i = 0; i < 4; i++ ) {
+      const uint64x2_t acc_vec  = vld1q_u64(acc + 2 * i);
+      const uint64x2_t key_vec  = vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i));
+      const uint64x2_t data_vec = veorq_u64(acc_vec, vshrq_n_u64(acc_vec, 47));
+      const uint64x2_t data_key = veorq_u64(data_vec, key_vec);
+
+      const uint32x2_t data_key_lo = vmovn_u64(data_key);
+      const uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+      const uint64x2_t prod_hi     = vshlq_n_u64(vmull_u32(data_key_hi, prime32), 32);
+      vst1q_u64(acc + 2 * i, vmlal_u32(prod_hi, data_key_lo, prime32));
+    }
+  }
+
+#endif // HAVE_XXH3_NEON
+
+  // Dispatch ////////////////////////////////////////////////////////////////
+
+  using Accumulate = void (*)(uint64_t *, const unsigned char *, const unsigned char *, const std::size_t);
+  using Scramble   = void (*)(uint64_t *, const unsigned char *);
+
+} // namespace impl_xxh3
+
+struct XXH3::Functions {
+  XXH3::Kernel kernel;
+  impl_xxh3::Accumulate accumulate;
+  impl_xxh3::Scramble scramble;
+};
+
+namespace impl_xxh3 {
+
+  constexpr XXH3::Functions FUNCS_SCALAR{XXH3::Kernel::Scalar, accumulate_scalar, scramble_scalar};
+#ifdef HAVE_XXH3_X86
+  constexpr XXH3::Functions FUNCS_SSE2{XXH3::Kernel::SSE2, accumulate_sse2, scramble_sse2};
+  constexpr XXH3::Functions FUNCS_AVX2{XXH3::Kernel::AVX2, accumulate_avx2, scramble_avx2};
+#endif
+#ifdef HAVE_XXH3_NEON
+  constexpr XXH3::Functions FUNCS_NEON{XXH3::Kernel::NEON, accumulate_neon, scramble_neon};
+#endif
+
+  const XXH3::Functions *functions(const XXH3::Kernel kernel)
+  {
+    if( kernel == XXH3::Kernel::Scalar ) {
+      return &FUNCS_SCALAR;
+    }
+#ifdef HAVE_XXH3_X86
+    if( kernel == XXH3::Kernel::SSE2 && hasSSE2() ) {
+      return &FUNCS_SSE2;
+    } else if( kernel == XXH3::Kernel::AVX2 && hasAVX2() ) {
+      return &FUNCS_AVX2;
+    }
+#endif
+#ifdef HAVE_XXH3_NEON
+    if( kernel == XXH3::Kernel::NEON ) {
+      return &FUNCS_NEON;
+    }
+#endif
+    return nullptr;
+  }
+
+  const XXH3::Functions *selectFunctions()
+  {
+    constexpr XXH3::Kernel PREFERENCE[] = {
+      XXH3::Kernel::AVX2, XXH3::Kernel::NEON, XXH3::Kernel::SSE2
+    };
+
+    for( const XXH3::Kernel kernel : PREFERENCE ) {
+      const XXH3::Functions *funcs = functions(kernel);
+      if( funcs != nullptr ) {
+        return funcs;
+      }
+    }
+
+    return &FUNCS_SCALAR;
+  }
+
+  const XXH3::Functions *autoFunctions()
+  {
+    static const XXH3::Functions *funcs = selectFunctions(); // Thread-safe, once
+    return funcs;
+  }
+
+  // Stripes /////////////////////////////////////////////////////////////////
+
+  /*
+   * NOTE: Every STRIPES_PER_BLOCK stripes, the accumulators are scrambled.
+   *       Consuming as many stripes as possible per call keeps the kernel's
+   *       indirect call off the hot path.
+   */
+
+  std::size_t consumeStripes(const XXH3::Functions *funcs, uint64_t *acc,
+                             std::size_t numStripesAcc,
+                             const unsigned char *input, std::size_t numStripes)
+  {
+    while( numStripes > 0 ) {
+      const std::size_t count = std::min(numStripes, STRIPES_PER_BLOCK - numStripesAcc);
+
+      funcs->accumulate(acc, input, SECRET + numStripesAcc * SECRET_CONSUME_RATE, count);
+      input         += count * STRIPE_LEN;
+      numStripes    -= count;
+      numStripesAcc += count;
+
+      if( numStripesAcc == STRIPES_PER_BLOCK ) {
+        funcs->scramble(acc, SECRET + SECRET_SIZE - STRIPE_LEN);
+        numStripesAcc = 0;
+      }
+    }
+
+    return numStripesAcc;
+  }
+
+  // XXH3-64 /////////////////////////////////////////////////////////////////
+
+  uint64_t xxh3_64_0to16(const unsigned char *input, const std::size_t len)
+  {
+    if( len > 8 ) {
+      const uint64_t flip1 = read64(SECRET + 24) ^ read64(SECRET + 32);
+      const uint64_t flip2 = read64(SECRET + 40) ^ read64(SECRET + 48);
+
+      const uint64_t input_lo = read64(input) ^ flip1;
+      const uint64_t input_hi = read64(input + len - 8) ^ flip2;
+
+      const uint64_t acc = len + swap64(input_lo) + input_hi + mul128_fold64(input_lo, input_hi);
+
+      return avalanche(acc);
+
+    } else if( len >= 4 ) {
+      const uint32_t input1 = read32(input);
+      const uint32_t input2 = read32(input + len - 4);
+
+      const uint64_t flip    = read64(SECRET + 8) ^ read64(SECRET + 16);
+      const uint64_t input64 = input2 + (static_cast<uint64_t>(input1) << 32);
+
+      return rrmxmx(input64 ^ flip, len);
+
+    } else if( len > 0 ) {
+      const uint32_t c1 = input[0];
+      const uint32_t c2 = input[len >> 1];
+      const uint32_t c3 = input[len - 1];
+
+      const uint32_t combined = (c1 << 16) | (c2 << 24) | c3 | (static_cast<uint32_t>(len) << 8);
+      const uint64_t flip     = read32(SECRET) ^ read32(SECRET + 4);
+
+      return avalanche_xxh64(combined ^ flip);
+    }
+
+    return avalanche_xxh64(read64(SECRET + 56) ^ read64(SECRET + 64));
+  }
+
+  uint64_t xxh3_64_17to128(const unsigned char *input, const std::size_t len)
+  {
+    uint64_t acc = len * PRIME64_1;
+
+    if( len > 32 ) {
+      if( len > 64 ) {
+        if( len > 96 ) {
+          acc += mix16(input + 48, SECRET + 96);
+          acc += mix16(input + len - 64, SECRET + 112);
+        }
+        acc += mix16(input + 32, SECRET + 64);
+        acc += mix16(input + len - 48, SECRET + 80);
+      }
+      acc += mix16(input + 16, SECRET + 32);
+      acc += mix16(input + len - 32, SECRET + 48);
+    }
+    acc += mix16(input, SECRET);
+    acc += mix16(input + len - 16, SECRET + 16);
+
+    return avalanche(acc);
+  }
+
+  uint64_t xxh3_64_129to240(const unsigned char *input, const std::size_t len)
+  {
+    constexpr std::size_t START_OFFSET = 3;
+    constexpr std::size_t LAST_OFFSET  = 17;
+
+    const std::size_t numRounds = len / 16;
+
+    uint64_t acc = len * PRIME64_1;
+    for( std::size_t i = 0; i < 8; i++ ) {
+      acc += mix16(input + 16 * i, SECRET + 16 * i);
+    }
+    acc = avalanche(acc);
+
+    for( std::size_t i = 8; i < numRounds; i++ ) {
+      acc += mix16(input + 16 * i, SECRET + 16 * (i - 8) + START_OFFSET);
+    }
+    acc += mix16(input + len - 16, SECRET + SECRET_SIZE_MIN - LAST_OFFSET);
+
+    return avalanche(acc);
+  }
+
+  uint64_t xxh3_64_short(const unsigned char *input, const std::size_t len)
+  {
+    if( len <= 16 ) {
+      return xxh3_64_0to16(input, len);
+    } else if( len <= 128 ) {
+      return xxh3_64_17to128(input, len);
+    }
+    return xxh3_64_129to240(input, len);
+  }
+
+  // XXH3-128 ////////////////////////////////////////////////////////////////
+
+  XXH3_128 xxh3_128_0to16(const unsigned char *input, const std::size_t len)
+  {
+    if( len > 8 ) {
+      const uint64_t flip_lo = read64(SECRET + 32) ^ read64(SECRET + 40);
+      const uint64_t flip_hi = read64(SECRET + 48) ^ read64(SECRET + 56);
+
+      const uint64_t input_lo = read64(input);
+      uint64_t       input_hi = read64(input + len - 8);
+
+      XXH3_128 m = mul128(input_lo ^ input_hi ^ flip_lo, PRIME64_1);
+      m.low      += static_cast<uint64_t>(len - 1) << 54;
+      input_hi   ^= flip_hi;
+      m.high     += input_hi + (input_hi & 0xFFFFFFFF) * (PRIME32_2 - 1);
+      m.low      ^= swap64(m.high);
+
+      XXH3_128 h = mul128(m.low, PRIME64_2);
+      h.high     += m.high * PRIME64_2;
+
+      return XXH3_128{avalanche(h.low), avalanche(h.high)};
+
+    } else if( len >= 4 ) {
+      const uint32_t input_lo = read32(input);
+      const uint32_t input_hi = read32(input + len - 4);
+
+      const uint64_t input64 = input_lo + (static_cast<uint64_t>(input_hi) << 32);
+      const uint64_t flip    = read64(SECRET + 16) ^ read64(SECRET + 24);
+
+      XXH3_128 m = mul128(input64 ^ flip, PRIME64_1 + (static_cast<uint64_t>(len) << 2));
+      m.high     += m.low << 1;
+      m.low      ^= m.high >> 3;
+
+      m.low  = xorshift64(m.low, 35) * PRIME_MX2;
+      m.low  = xorshift64(m.low, 28);
+      m.high = avalanche(m.high);
+
+      return m;
+
+    } else if( len > 0 ) {
+      const uint32_t c1 = input[0];
+      const uint32_t c2 = input[len >> 1];
+      const uint32_t c3 = input[len - 1];
+
+      const uint32_t combined_lo = (c1 << 16) | (c2 << 24) | c3 | (static_cast<uint32_t>(len) << 8);
+      const uint32_t combined_hi = std::rotl(swap32(combined_lo), 13);
+
+      const uint64_t flip_lo = read32(SECRET) ^ read32(SECRET + 4);
+      const uint64_t flip_hi = read32(SECRET + 8) ^ read32(SECRET + 12);
+
+      return XXH3_128{avalanche_xxh64(combined_lo ^ flip_lo), avalanche_xxh64(combined_hi ^ flip_hi)};
+    }
+
+    return XXH3_128{avalanche_xxh64(read64(SECRET + 64) ^ read64(SECRET + 72)),
+                    avalanche_xxh64(read64(SECRET + 80) ^ read64(SECRET + 88))};
+  }
+
+  XXH3_128 xxh3_128_finalize(const uint64_t lo, const uint64_t hi, const std::size_t len)
+  {
+    return XXH3_128{avalanche(lo + hi),
+                    0 - avalanche(lo * PRIME64_1 + hi * PRIME64_4 + len * PRIME64_2)};
+  }
+
+  XXH3_128 xxh3_128_17to128(const unsigned char *input, const std::size_t len)
+  {
+    uint64_t lo = len * PRIME64_1;
+    uint64_t hi = 0;
+
+    if( len > 32 ) {
+      if( len > 64 ) {
+        if( len > 96 ) {
+          mix32(lo, hi, input + 48, input + len - 64, SECRET + 96);
+        }
+        mix32(lo, hi, input + 32, input + len - 48, SECRET + 64);
+      }
+      mix32(lo, hi, input + 16, input + len - 32, SECRET + 32);
+    }
+    mix32(lo, hi, input, input + len - 16, SECRET);
+
+    return xxh3_128_finalize(lo, hi, len);
+  }
+
+  XXH3_128 xxh3_128_129to240(const unsigned char *input, const std::size_t len)
+  {
+    constexpr std::size_t START_OFFSET = 3;
+    constexpr std::size_t LAST_OFFSET  = 17;
+
+    const std::size_t numRounds = len / 32;
+
+    uint64_t lo = len * PRIME64_1;
+    uint64_t hi = 0;
+    for( std::size_t i = 0; i < 4; i++ ) {
+      mix32(lo, hi, input + 32 * i, input + 32 * i + 16, SECRET + 32 * i);
+    }
+    lo = avalanche(lo);
+    hi = avalanche(hi);
+
+    for( std::size_t i = 4; i < numRounds; i++ ) {
+      mix32(lo, hi, input + 32 * i, input + 32 * i + 16, SECRET + START_OFFSET + 32 * (i - 4));
+    }
+    mix32(lo, hi, input + len - 16, input + len - 32, SECRET + SECRET_SIZE_MIN - LAST_OFFSET - 16);
+
+    return xxh3_128_finalize(lo, hi, len);
+  }
+
+  XXH3_128 xxh3_128_short(const unsigned char *input, const std::size_t len)
+  {
+    if( len <= 16 ) {
+      return xxh3_128_0to16(input, len);
+    } else if( len <= 128 ) {
+      return xxh3_128_17to128(input, len);
+    }
+    return xxh3_128_129to240(input, len);
+  }
+
+} // namespace impl_xxh3
+
+////// public ////////////////////////////////////////////////////////////////
+
+XXH3::XXH3(const Kernel kernel) noexcept
+{
+  if( kernel != Kernel::Auto ) {
+    _funcs = impl_xxh3::functions(kernel);
+  }
+  if( _funcs == nullptr ) {
+    _funcs = impl_xxh3::autoFunctions();
+  }
+
+  reset();
+}
+
+XXH3::~XXH3() noexcept
+{
+}
+
+void XXH3::reset()
+{
+  std::memcpy(_acc, impl_xxh3::INIT_ACC, sizeof(_acc));
+  _numBuffered   = 0;
+  _numStripesAcc = 0;
+  _totalSize     = 0;
+}
+
+void XXH3::update(const void *data, const std::size_t size)
+{
+  using namespace impl_xxh3;
+
+  constexpr std::size_t BUFFER_STRIPES = BUFFER_SIZE / STRIPE_LEN;
+
+  const unsigned char *input = reinterpret_cast<const unsigned char *>(data);
+  std::size_t          len   = size;
+
+  _totalSize += len;
+
+  if( _numBuffered + len <= BUFFER_SIZE ) {
+    if( len > 0 ) {
+      std::memcpy(_buffer + _numBuffered, input, len);
+      _numBuffered += len;
+    }
+    return;
+  }
+
+  // (1) Complete & consume buffer ///////////////////////////////////////////
+
+  if( _numBuffered > 0 ) {
+    const std::size_t fill = BUFFER_SIZE - _numBuffered;
+
+    std::memcpy(_buffer + _numBuffered, input, fill);
+    input += fill;
+    len   -= fill;
+
+    _numStripesAcc = consumeStripes(_funcs, _acc, _numStripesAcc, _buffer, BUFFER_STRIPES);
+    _numBuffered   = 0;
+  }
+
+  // (2) Consume input in place; always keep 1..BUFFER_SIZE bytes ////////////
+
+  if( len > BUFFER_SIZE ) {
+    const std::size_t numBlocks = (len - 1) / BUFFER_SIZE;
+
+    _numStripesAcc = consumeStripes(_funcs, _acc, _numStripesAcc, input, numBlocks * BUFFER_STRIPES);
+    input += numBlocks * BUFFER_SIZE;
+    len   -= numBlocks * BUFFER_SIZE;
+
+    // Last stripe consumed, for digest()'s catch up...
+    std::memcpy(_buffer + BUFFER_SIZE - STRIPE_LEN, input - STRIPE_LEN, STRIPE_LEN);
+  }
+
+  // (3) Buffer remainder ////////////////////////////////////////////////////
+
+  std::memcpy(_buffer, input, len);
+  _numBuffered = len;
+}
+
+uint64_t XXH3::digest64() const
+{
+  using namespace impl_xxh3;
+
+  if( _totalSize <= MID_SIZE_MAX ) {
+    return xxh3_64_short(_buffer, _numBuffered);
+  }
+
+  alignas(64) uint64_t acc[NUM_ACC];
+  digestLong(acc);
+
+  return merge_accs(acc, SECRET + SECRET_MERGEACCS_START, _totalSize * PRIME64_1);
+}
+
+XXH3_128 XXH3::digest128() const
+{
+  using namespace impl_xxh3;
+
+  if( _totalSize <= MID_SIZE_MAX ) {
+    return xxh3_128_short(_buffer, _numBuffered);
+  }
+
+  alignas(64) uint64_t acc[NUM_ACC];
+  digestLong(acc);
+
+  XXH3_128 result;
+  result.low  = merge_accs(acc, SECRET + SECRET_MERGEACCS_START,
+                           _totalSize * PRIME64_1);
+  result.high = merge_accs(acc, SECRET + SECRET_SIZE - sizeof(acc) - SECRET_MERGEACCS_START,
+                           ~(_totalSize * PRIME64_2));
+
+  return result;
+}
+
+XXH3::Kernel XXH3::kernel() const
+{
+  return _funcs->kernel;
+}
+
+bool XXH3::isSupported(const Kernel kernel)
+{
+  return kernel == Kernel::Auto || impl_xxh3::functions(kernel) != nullptr;
+}
+
+const char *XXH3::name(const Kernel kernel)
+{
+  if( kernel == Kernel::Scalar ) {
+    return "Scalar";
+  } else if( kernel == Kernel::SSE2 ) {
+    return "SSE2";
+  } else if( kernel == Kernel::AVX2 ) {
+    return "AVX2";
+  } else if( kernel == Kernel::NEON ) {
+    return "NEON";
+  }
+  return "Auto";
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void XXH3::digestLong(uint64_t *acc) const
+{
+  using namespace impl_xxh3;
+
+  std::memcpy(acc, _acc, sizeof(_acc));
+
+  const unsigned char *lastSecret = SECRET + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START;
+
+  if( _numBuffered >= STRIPE_LEN ) {
+    const std::size_t numStripes = (_numBuffered - 1) / STRIPE_LEN;
+    consumeStripes(_funcs, acc, _numStripesAcc, _buffer, numStripes);
+
+    _funcs->accumulate(acc, _buffer + _numBuffered - STRIPE_LEN, lastSecret, 1);
+
+  } else {
+    // Catch up on the previously consumed stripe...
+    alignas(64) unsigned char lastStripe[STRIPE_LEN];
+    const std::size_t         catchup = STRIPE_LEN - _numBuffered;
+
+    std::memcpy(lastStripe, _buffer + BUFFER_SIZE - catchup, catchup);
+    std::memcpy(lastStripe + catchup, _buffer, _numBuffered);
+
+    _funcs->accumulate(acc, lastStripe, lastSecret, 1);
+  }
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+uint64_t xxh3_64(const void *data, const std::size_t size)
+{
+  XXH3 state;
+  state.update(data, size);
+  return state.digest64();
+}
+
+XXH3_128 xxh3_128(const void *data, const std::size_t size)
+{
+  XXH3 state;
+  state.update(data, size);
+  return state.digest128();
+}
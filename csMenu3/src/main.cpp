@@ -34,6 +34,7 @@
 #include "MainMenuFactory.h"
 #include "Register.h"
 #include "ScriptMenuFactory.h"
+#include "ThreadPool.h"
 #include "Win32/ProgressBar.h"
 #include "Win32/WindowUtil.h"
 
@@ -54,6 +55,11 @@ HRESULT WINAPI DllCanUnloadNow()
     return S_FALSE;
   }
 
+  // Jobs & workers must not outlive the DLL.
+  if( !ThreadPool::instance().release() ) {
+    return S_FALSE;
+  }
+
   winrt::clear_factory_cache();
 
   return S_OK;
@@ -0,0 +1,360 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Commands.h"
+#include "HashFunction.h"
+#include "XXH3.h"
+
+/*
+ * Output is CSV, one line per measurement:
+ *
+ * bench,function,kernel,size,files,bytes,seconds,gbps,files_per_s,allocs_per_file
+ *
+ * - "buffer" measures XXH3's kernels in memory, i.e. without I/O.
+ * - "file" hashes one (cached) file of the given size, repeatedly.
+ * - "set" hashes a generated set of files once per repetition,
+ *   "size" is the set's name then.
+ */
+
+////// Allocations ///////////////////////////////////////////////////////////
+
+std::atomic<uint64_t> g_numAllocs{0};
+
+void *operator new(std::size_t size)
+{
+  g_numAllocs.fetch_add(1, std::memory_order_relaxed);
+  if( void *ptr = std::malloc(size > 0 ? size : 1); ptr != nullptr ) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+////// Types /////////////////////////////////////////////////////////////////
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+using Buffer = std::vector<unsigned char>;
+
+struct Function {
+  std::string name;
+  HashFunction func{HashFunction::Invalid};
+};
+
+using Functions = std::vector<Function>;
+
+struct FileSet {
+  std::string name;
+  std::vector<fs::path> files;
+  uint64_t numBytes{0};
+};
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t KiB = 1024;
+constexpr std::size_t MiB = 1024 * KiB;
+
+constexpr std::size_t SIZES[] = {
+  64, 256, 1 * KiB, 4 * KiB, 16 * KiB, 64 * KiB, 256 * KiB,
+  1 * MiB, 4 * MiB, 16 * MiB, 64 * MiB};
+
+// Repeat each measurement at least MIN_REPS times & MIN_DURATION long...
+constexpr int MIN_REPS = 3;
+constexpr std::chrono::milliseconds MIN_DURATION{250};
+
+////// Helpers ///////////////////////////////////////////////////////////////
+
+std::string narrow(const std::wstring& str)
+{
+  std::string result;
+  for( const wchar_t ch : str ) {
+    result.push_back(ch < 0x80 ? static_cast<char>(ch) : '?');
+  }
+  return result;
+}
+
+Functions reachableFunctions()
+{
+  constexpr CommandId FIRST = static_cast<CommandId>(Command::HashMenu) + 1;
+  constexpr CommandId LAST  = static_cast<CommandId>(Command::ScriptMenu);
+
+  Functions result;
+  for( CommandId id = FIRST; id < LAST; id++ ) {
+    const HashFunction func = idToHashFunction(id);
+    if( func != HashFunction::Invalid ) {
+      result.push_back(Function{narrow(titleFromId(id)), func});
+    }
+  }
+
+  return result;
+}
+
+Buffer makeRandom(const std::size_t size, const uint64_t seed)
+{
+  std::mt19937_64 rng(seed);
+
+  Buffer result(size);
+  for( std::size_t i = 0; i < size; i++ ) {
+    result[i] = static_cast<unsigned char>(rng());
+  }
+
+  return result;
+}
+
+bool writeFile(const fs::path& filename, const Buffer& data)
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+  return file.good();
+}
+
+void report(const char *bench, const std::string& function, const char *kernel,
+            const std::string& size, const std::size_t numFiles, const uint64_t numBytes,
+            const double seconds, const uint64_t numAllocs)
+{
+  const double gbps        = seconds > 0 ? double(numBytes) / seconds / 1e9 : 0;
+  const double files_per_s = seconds > 0 ? double(numFiles) / seconds : 0;
+  const double allocs      = numFiles > 0 ? double(numAllocs) / double(numFiles) : 0;
+
+  std::printf("%s,%s,%s,%s,%zu,%llu,%.6f,%.3f,%.1f,%.2f\n",
+              bench, function.data(), kernel, size.data(), numFiles,
+              static_cast<unsigned long long>(numBytes), seconds, gbps, files_per_s, allocs);
+  std::fflush(stdout);
+}
+
+/*
+ * Runs 'work' until both MIN_REPS and MIN_DURATION are exceeded;
+ * returns the number of repetitions, the elapsed time & allocations.
+ */
+
+template <typename WorkFunc>
+void measure(WorkFunc&& work, int& numReps, double& seconds, uint64_t& numAllocs)
+{
+  work(); // Warm up; e.g. the file cache
+
+  const uint64_t allocs0 = g_numAllocs.load();
+  const Clock::time_point start = Clock::now();
+
+  numReps = 0;
+  Clock::duration elapsed;
+  do {
+    work();
+    numReps++;
+    elapsed = Clock::now() - start;
+  } while( numReps < MIN_REPS || elapsed < MIN_DURATION );
+
+  seconds   = std::chrono::duration<double>(elapsed).count();
+  numAllocs = g_numAllocs.load() - allocs0;
+}
+
+////// Benchmarks ////////////////////////////////////////////////////////////
+
+std::atomic<uint64_t> g_sink{0}; // Keep results alive
+
+void benchBuffers()
+{
+  constexpr XXH3::Kernel KERNELS[] = {
+    XXH3::Kernel::Scalar, XXH3::Kernel::SSE2, XXH3::Kernel::AVX2, XXH3::Kernel::NEON};
+
+  const Buffer data = makeRandom(SIZES[std::size(SIZES) - 1], 1);
+
+  for( const XXH3::Kernel kernel : KERNELS ) {
+    if( !XXH3::isSupported(kernel) ) {
+      continue;
+    }
+
+    for( const std::size_t size : SIZES ) {
+      for( const bool is128 : {false, true} ) {
+        const auto work = [&]() -> void {
+          XXH3 state(kernel);
+          state.update(data.data(), size);
+          g_sink.fetch_add(is128
+                           ? state.digest128().low
+                           : state.digest64(), std::memory_order_relaxed);
+        };
+
+        int numReps;
+        double seconds;
+        uint64_t numAllocs;
+        measure(work, numReps, seconds, numAllocs);
+
+        report("buffer", is128 ? "XXH3-128" : "XXH3-64", XXH3::name(kernel),
+               std::to_string(size), numReps, uint64_t(numReps) * size, seconds, numAllocs);
+      }
+    }
+  }
+}
+
+void benchFiles(const Functions& functions, const fs::path& root)
+{
+  const char *kernel = XXH3::name(XXH3().kernel());
+
+  const Buffer data = makeRandom(SIZES[std::size(SIZES) - 1], 2);
+
+  for( const std::size_t size : SIZES ) {
+    const fs::path filename = root / ("file_" + std::to_string(size) + ".bin");
+    if( !writeFile(filename, Buffer(data.begin(), data.begin() + size)) ) {
+      std::fprintf(stderr, "ERROR: writeFile(%s)!\n", filename.string().data());
+      continue;
+    }
+
+    for( const Function& f : functions ) {
+      const auto work = [&]() -> void {
+        g_sink.fetch_add(digest(filename, f.func).size(), std::memory_order_relaxed);
+      };
+
+      int numReps;
+      double seconds;
+      uint64_t numAllocs;
+      measure(work, numReps, seconds, numAllocs);
+
+      report("file", f.name, kernel, std::to_string(size),
+             numReps, uint64_t(numReps) * size, seconds, numAllocs);
+    }
+
+    std::error_code ec;
+    fs::remove(filename, ec);
+  }
+}
+
+FileSet makeFileSet(const fs::path& root, const std::string& name,
+                    const std::size_t numFiles, const std::size_t minSize, const std::size_t maxSize)
+{
+  FileSet result;
+  result.name = name;
+
+  const fs::path dir = root / name;
+  std::error_code ec;
+  fs::create_directories(dir, ec);
+
+  // File sizes are distributed log-uniformly in [minSize, maxSize].
+  std::mt19937_64 rng(numFiles);
+  std::uniform_real_distribution<double> dist(std::log2(double(minSize)), std::log2(double(maxSize)));
+
+  const Buffer data = makeRandom(maxSize, 3);
+  for( std::size_t i = 0; i < numFiles; i++ ) {
+    const std::size_t size = minSize == maxSize
+                             ? minSize
+                             : static_cast<std::size_t>(std::exp2(dist(rng)));
+
+    const fs::path filename = dir / ("file_" + std::to_string(i) + ".bin");
+    if( !writeFile(filename, Buffer(data.begin(), data.begin() + size)) ) {
+      std::fprintf(stderr, "ERROR: writeFile(%s)!\n", filename.string().data());
+      continue;
+    }
+
+    result.files.push_back(filename);
+    result.numBytes += size;
+  }
+
+  return result;
+}
+
+void benchFileSets(const Functions& functions, const fs::path& root)
+{
+  const char *kernel = XXH3::name(XXH3().kernel());
+
+  const FileSet sets[] = {
+    makeFileSet(root, "tiny_4096x1KiB", 4096, 1 * KiB, 1 * KiB),
+    makeFileSet(root, "small_1024x4-64KiB", 1024, 4 * KiB, 64 * KiB),
+    makeFileSet(root, "mixed_256x1KiB-16MiB", 256, 1 * KiB, 16 * MiB),
+    makeFileSet(root, "large_4x64MiB", 4, 64 * MiB, 64 * MiB)};
+
+  for( const FileSet& set : sets ) {
+    for( const Function& f : functions ) {
+      const auto work = [&]() -> void {
+        for( const fs::path& filename : set.files ) {
+          g_sink.fetch_add(digest(filename, f.func).size(), std::memory_order_relaxed);
+        }
+      };
+
+      int numReps;
+      double seconds;
+      uint64_t numAllocs;
+      measure(work, numReps, seconds, numAllocs);
+
+      report("set", f.name, kernel, set.name, numReps * set.files.size(),
+             uint64_t(numReps) * set.numBytes, seconds, numAllocs);
+    }
+  }
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  // Usage: bench_hash [buffer|file|set]...
+  bool is_buffer = argc < 2;
+  bool is_file   = argc < 2;
+  bool is_set    = argc < 2;
+  for( int i = 1; i < argc; i++ ) {
+    const std::string arg(argv[i]);
+    is_buffer = is_buffer || arg == "buffer";
+    is_file   = is_file || arg == "file";
+    is_set    = is_set || arg == "set";
+  }
+
+  const Functions functions = reachableFunctions();
+
+  std::error_code ec;
+  const fs::path root = fs::temp_directory_path(ec) /
+                        ("csMenu3_bench_" + std::to_string(std::random_device{}()));
+  if( ec || !fs::create_directories(root, ec) ) {
+    std::fprintf(stderr, "ERROR: Unable to create temporary directory!\n");
+    return EXIT_FAILURE;
+  }
+
+  std::printf("bench,function,kernel,size,files,bytes,seconds,gbps,files_per_s,allocs_per_file\n");
+
+  if( is_buffer ) {
+    benchBuffers();
+  }
+  if( is_file ) {
+    benchFiles(functions, root);
+  }
+  if( is_set ) {
+    benchFileSets(functions, root);
+  }
+
+  fs::remove_all(root, ec);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,290 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>
+
+#include "Rename.h"
+#include "RenameEngine.h"
+#include "RenamePlan.h"
+
+/*
+ * Output is CSV, one line per measurement:
+ *
+ * mode,files,dirs,renamed,plan_s,execute_s,renames_per_s,io_per_rename,allocs_per_rename,root
+ *
+ * - Each mode renames a generated tree of files, using the same code path
+ *   as invokeRename(), i.e. RenameEngine & RenamePlan; the tree is then
+ *   renamed back, untimed, for the next repetition.
+ * - "io_per_rename" counts the process' I/O operations other than reads &
+ *   writes (cf. GetProcessIoCounters()), i.e. opens, queries & renames;
+ *   it serves as a proxy for system calls.
+ * - Pass the roots of the trees, e.g. a RAM disk & a physical disk, to
+ *   compare file systems; the default root is the temporary directory.
+ */
+
+////// Allocations ///////////////////////////////////////////////////////////
+
+std::atomic<uint64_t> g_numAllocs{0};
+
+void *operator new(std::size_t size)
+{
+  g_numAllocs.fetch_add(1, std::memory_order_relaxed);
+  if( void *ptr = std::malloc(size > 0 ? size : 1); ptr != nullptr ) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+////// Types /////////////////////////////////////////////////////////////////
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+// Renames the tree forward (timed) & backward (untimed).
+struct Mode {
+  std::string name;
+  Rename forward;
+  Rename backward;
+};
+
+using Modes = std::vector<Mode>;
+
+struct Result {
+  std::size_t numRenamed{0};
+  double planSeconds{0};
+  double executeSeconds{0};
+  uint64_t numIo{0};
+  uint64_t numAllocs{0};
+};
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t FILES_PER_DIR = 1000;
+
+constexpr std::size_t NUM_FILES[] = {10000, 100000};
+
+constexpr int NUM_REPS = 3;
+
+////// Helpers ///////////////////////////////////////////////////////////////
+
+Modes allModes()
+{
+  return Modes{
+    Mode{"Append", Rename(Rename::Append, L"_new"), Rename(Rename::Remove, L"_new")},
+    Mode{"Prepend", Rename(Rename::Prepend, L"new_"), Rename(Rename::Remove, L"new_")},
+    Mode{"Remove", Rename(Rename::Remove, L"file_"), Rename(Rename::Prepend, L"file_")},
+    Mode{"Replace", Rename(Rename::Replace, L"file", L"item"), Rename(Rename::Replace, L"item", L"file")},
+    Mode{"Regex", Rename(Rename::Regex, L"^file_(\\d+)$", L"${1}_file"),
+         Rename(Rename::Regex, L"^(\\d+)_file$", L"file_$1")},
+    Mode{"Multi", Rename(Rename::Multi, L"(?i)FILE|_", L"doc|-"), Rename(Rename::Multi, L"doc|-", L"file|_")}
+  };
+}
+
+std::string narrow(const std::wstring& str)
+{
+  std::string result;
+  for( const wchar_t ch : str ) {
+    result.push_back(ch < 0x80 ? static_cast<char>(ch) : '?');
+  }
+  return result;
+}
+
+uint64_t numOtherIo()
+{
+  IO_COUNTERS counters;
+  if( GetProcessIoCounters(GetCurrentProcess(), &counters) == FALSE ) {
+    return 0;
+  }
+  return counters.OtherOperationCount;
+}
+
+cs::PathList makeTree(const fs::path& root, const std::size_t numFiles)
+{
+  cs::PathList result;
+
+  std::error_code ec;
+  for( std::size_t i = 0; i < numFiles; i++ ) {
+    const fs::path dir = root / ("dir_" + std::to_string(i / FILES_PER_DIR));
+    if( i % FILES_PER_DIR == 0 ) {
+      fs::create_directories(dir, ec);
+    }
+
+    const fs::path filename = dir / ("file_" + std::to_string(i) + ".dat");
+    if( !std::ofstream(filename, std::ios::binary | std::ios::trunc).good() ) {
+      std::fprintf(stderr, "ERROR: makeTree(%s)!\n", filename.string().data());
+      continue;
+    }
+
+    result.push_back(filename);
+  }
+
+  return result;
+}
+
+// New paths of all renamed files; unchanged files keep their path.
+cs::PathList renamedFiles(const RenamePlan& plan)
+{
+  cs::PathList result;
+  for( const RenamePlan::Item& item : plan.items() ) {
+    result.push_back(item.status == RenamePlan::Status::Renamed
+                     ? item.source.parent_path() / item.target
+                     : item.source);
+  }
+
+  return result;
+}
+
+// cf. renameFiles() in Invoke.cpp
+bool renameFiles(cs::PathList& files, const Rename& rename, Result *result)
+{
+  const uint64_t io0     = numOtherIo();
+  const uint64_t allocs0 = g_numAllocs.load();
+  const Clock::time_point start = Clock::now();
+
+  const RenameEngine engine(rename);
+  if( !engine.isValid() ) {
+    return false;
+  }
+
+  RenamePlan plan;
+  if( !plan.plan(files, engine) ) {
+    return false;
+  }
+
+  const Clock::time_point planned = Clock::now();
+
+  const std::size_t numRenamed = plan.execute();
+
+  const Clock::time_point executed = Clock::now();
+
+  if( result != nullptr ) {
+    result->numRenamed     += numRenamed;
+    result->planSeconds    += std::chrono::duration<double>(planned - start).count();
+    result->executeSeconds += std::chrono::duration<double>(executed - planned).count();
+    result->numIo          += numOtherIo() - io0;
+    result->numAllocs      += g_numAllocs.load() - allocs0;
+  }
+
+  files = renamedFiles(plan);
+
+  return numRenamed == files.size();
+}
+
+void report(const Mode& mode, const std::size_t numFiles, const Result& result, const fs::path& root)
+{
+  const double seconds       = result.planSeconds + result.executeSeconds;
+  const double renames_per_s = seconds > 0 ? double(result.numRenamed) / seconds : 0;
+  const double io            = result.numRenamed > 0 ? double(result.numIo) / double(result.numRenamed) : 0;
+  const double allocs        = result.numRenamed > 0 ? double(result.numAllocs) / double(result.numRenamed) : 0;
+
+  std::printf("%s,%zu,%zu,%zu,%.6f,%.6f,%.1f,%.2f,%.2f,%s\n",
+              mode.name.data(), numFiles, (numFiles + FILES_PER_DIR - 1) / FILES_PER_DIR,
+              result.numRenamed, result.planSeconds, result.executeSeconds,
+              renames_per_s, io, allocs, narrow(root.wstring()).data());
+  std::fflush(stdout);
+}
+
+////// Benchmarks ////////////////////////////////////////////////////////////
+
+void benchRename(const Modes& modes, const fs::path& base, const std::size_t numFiles)
+{
+  const fs::path root = base / ("csMenu3_bench_" + std::to_string(std::random_device{}()));
+
+  cs::PathList files = makeTree(root, numFiles);
+
+  for( const Mode& mode : modes ) {
+    Result result;
+    for( int rep = 0; rep < NUM_REPS; rep++ ) {
+      if( !renameFiles(files, mode.forward, &result) ) {
+        std::fprintf(stderr, "ERROR: %s: Forward rename failed!\n", mode.name.data());
+      }
+      if( !renameFiles(files, mode.backward, nullptr) ) {
+        std::fprintf(stderr, "ERROR: %s: Backward rename failed!\n", mode.name.data());
+      }
+    }
+
+    report(mode, files.size(), result, base);
+  }
+
+  std::error_code ec;
+  fs::remove_all(root, ec);
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  // Usage: bench_rename [numFiles|root]...
+  std::vector<std::size_t> counts;
+  std::vector<fs::path> roots;
+  for( int i = 1; i < argc; i++ ) {
+    const std::string arg(argv[i]);
+    if( arg.find_first_not_of("0123456789") == std::string::npos ) {
+      counts.push_back(std::stoull(arg));
+    } else {
+      roots.push_back(fs::path(arg));
+    }
+  }
+
+  if( counts.empty() ) {
+    counts.assign(std::begin(NUM_FILES), std::end(NUM_FILES));
+  }
+  if( roots.empty() ) {
+    std::error_code ec;
+    roots.push_back(fs::temp_directory_path(ec));
+    if( ec ) {
+      std::fprintf(stderr, "ERROR: No temporary directory!\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  const Modes modes = allModes();
+
+  std::printf("mode,files,dirs,renamed,plan_s,execute_s,renames_per_s,io_per_rename,allocs_per_rename,root\n");
+
+  for( const fs::path& root : roots ) {
+    for( const std::size_t numFiles : counts ) {
+      benchRename(modes, root, numFiles);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,384 @@
+#include <cstdlib>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cs/Text/PrintFormat.h>
+#include <cs/Text/PrintUtil.h>
+
+#include "MultiReplace.h"
+#include "Regex.h"
+#include "Rename.h"
+#include "RenameEngine.h"
+#include "RenamePlan.h"
+#include "SortKey.h"
+#include "ThreadPool.h"
+
+/*
+ * NOTE: Each check prints its result & title; the program fails if any
+ *       check fails. The RenamePlan checks rename files in a scratch
+ *       directory below the temporary directory; each file's content is
+ *       its original name (UTF-8), i.e. renames can be traced afterwards.
+ */
+
+////// Types /////////////////////////////////////////////////////////////////
+
+namespace fs = std::filesystem;
+
+using Names = std::vector<std::wstring>;
+
+using Contents = std::map<std::wstring, std::wstring>; // Name -> Original Name
+
+using Status = RenamePlan::Status;
+
+////// Checks ////////////////////////////////////////////////////////////////
+
+int g_numFailed = 0;
+
+void check(const bool is_ok, const char *title)
+{
+  if( !is_ok ) {
+    g_numFailed++;
+  }
+
+  cs::println("% %", is_ok ? "OK    " : "FAILED", title);
+}
+
+////// Regex /////////////////////////////////////////////////////////////////
+
+// An expected result of nullptr requires the pattern to be invalid.
+void checkRegex(const char *title, const wchar_t *pattern, const wchar_t *replace,
+                const wchar_t *input, const wchar_t *expected)
+{
+  const Regex regex(pattern, replace);
+  if( expected == nullptr ) {
+    check(!regex.isValid(), title);
+    return;
+  }
+
+  std::wstring result;
+  check(regex.isValid() && regex.replaceAll(result, input) && result == expected, title);
+}
+
+void testRegex()
+{
+  cs::println("*** Regex");
+
+  checkRegex("Literal", L"abc", L"X", L"xxabcxxabc", L"xxXxxX");
+  checkRegex("Groups", L"(\\d+)x(\\d+)", L"$2x$1", L"img_1920x1080", L"img_1080x1920");
+  checkRegex("Braced group", L"^(.*)_(\\d{4})$", L"${2}_$1", L"holiday_2023", L"2023_holiday");
+  checkRegex("Empty matches", L"a*", L"-", L"baaac", L"-b--c-");
+  checkRegex("Ignore case", L"(?i)IMG", L"photo", L"img_Img_IMG", L"photo_photo_photo");
+  checkRegex("Ignore case, non-ASCII", L"(?i)\u00E4rger", L"X", L"\u00C4RGER_\u00E4rger", L"X_X");
+  checkRegex("Ignore case, non-ASCII class", L"(?i)[\u00E0-\u00FE]+", L"X", L"a\u00C4\u00E9\u00C9b", L"aXb");
+  checkRegex("Class", L"[a-c]+", L"<$0>", L"xxabcabyy", L"xx<abcab>yy");
+  checkRegex("Negated class", L"[^a-z]", L"", L"ab1c2_d", L"abcd");
+  checkRegex("Leftmost alternative", L"(a|ab)(c|bcd)(d*)", L"[$1|$2|$3]", L"abcd", L"[a|bcd|]");
+  checkRegex("Lazy quantifier", L"(a+?)(a*)", L"$1:$2", L"aaa", L"a:aa");
+  checkRegex("Counted quantifier", L"x{2,3}", L"Y", L"xxxxxxx", L"YYx");
+  checkRegex("Escaped dollar", L"\\.", L"$$", L"a.b", L"a$b");
+  checkRegex("Unmatched group", L"(a)|(b)", L"[$1$2]", L"ab", L"[a][b]");
+  checkRegex("No backtracking", L"((a*)*)*b", L"X",
+             L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaac",
+             L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaac");
+  checkRegex("Invalid: Open group", L"(", L"", L"", nullptr);
+  checkRegex("Invalid: Nested quantifier", L"a**", L"", L"", nullptr);
+  checkRegex("Invalid: Missing group", L"a", L"$2", L"", nullptr);
+  checkRegex("Invalid: Range", L"[z-a]", L"", L"", nullptr);
+}
+
+////// MultiReplace //////////////////////////////////////////////////////////
+
+// An expected result of nullptr requires the patterns to be invalid.
+void checkMulti(const char *title, const wchar_t *patterns, const wchar_t *replaces,
+                const wchar_t *input, const wchar_t *expected)
+{
+  const MultiReplace multi(patterns, replaces);
+  if( expected == nullptr ) {
+    check(!multi.isValid(), title);
+    return;
+  }
+
+  std::wstring result;
+  check(multi.isValid() && multi.replaceAll(result, input) && result == expected, title);
+}
+
+void testMultiReplace()
+{
+  cs::println("*** MultiReplace");
+
+  checkMulti("Single replacement", L"_final|copy| (1)", L"", L"report_final copy (1)", L"report ");
+  checkMulti("Leftmost wins", L"bc|abcd", L"X|Y", L"abcde", L"Ye");
+  checkMulti("Longest wins", L"a|ab|abc", L"1|2|3", L"abcab", L"32");
+  checkMulti("Failure links", L"he|she|his|hers", L"1|2|3|4", L"ushers", L"u2rs");
+  checkMulti("No overlaps", L"aa", L"b", L"aaaaa", L"bba");
+  checkMulti("Ignore case", L"(?i)COPY", L"", L"Copy of cOpY.txt", L" of .txt");
+  checkMulti("Ignore case, non-ASCII", L"(?i)\u00C9T\u00C9", L"summer", L"\u00E9t\u00E9_\u00C9t\u00E9", L"summer_summer");
+  checkMulti("Invalid: Count of replacements", L"x", L"1|2", L"x", nullptr);
+}
+
+////// SortKey ///////////////////////////////////////////////////////////////
+
+// The names are expected in ascending, strict order.
+void checkOrder(const char *title, const Names& names)
+{
+  bool is_ok = true;
+  for( std::size_t i = 1; i < names.size(); i++ ) {
+    is_ok = is_ok && makeSortKey(names[i - 1]) < makeSortKey(names[i]);
+  }
+
+  check(is_ok, title);
+}
+
+void testSortKey()
+{
+  cs::println("*** SortKey");
+
+  checkOrder("Numbers", {L"file1", L"file2", L"file9", L"file10", L"file100"});
+  checkOrder("Numbers ignore case", {L"File9.txt", L"file10.txt", L"FILE11.txt"});
+  checkOrder("Letters ignore case", {L"a", L"B", L"c", L"D"});
+  checkOrder("Separators first", {L"dir\\z", L"dir z", L"dirz"});
+  checkOrder("Accents by base letter", {L"apple", L"\u00E9clair", L"zebra"}); // e with acute
+
+  check(makeSortKey(L"abc") == makeSortKey(L"ABC"), "Same key for case only");
+  check(makeSortKey(L"\u00E4rger") == makeSortKey(L"\u00C4RGER"), "Same key for non-ASCII case only");
+}
+
+////// RenamePlan ////////////////////////////////////////////////////////////
+
+fs::path g_root;
+
+void makeFiles(const Names& names)
+{
+  fs::remove_all(g_root);
+  fs::create_directories(g_root);
+
+  for( const std::wstring& name : names ) {
+    const std::u8string content = fs::path(name).u8string();
+
+    std::ofstream file(g_root / name, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(content.data()), content.size());
+  }
+}
+
+Contents listFiles()
+{
+  Contents result;
+  for( const fs::directory_entry& entry : fs::directory_iterator(g_root) ) {
+    std::ifstream file(entry.path(), std::ios::binary);
+
+    std::string content;
+    std::getline(file, content);
+
+    const std::u8string original(content.begin(), content.end());
+    result[entry.path().filename().wstring()] = fs::path(original).wstring();
+  }
+
+  return result;
+}
+
+Contents unchanged(const Names& names)
+{
+  Contents result;
+  for( const std::wstring& name : names ) {
+    result[name] = name;
+  }
+
+  return result;
+}
+
+void planFiles(RenamePlan& plan, const Rename& rename, const Names& names)
+{
+  cs::PathList files;
+  for( const std::wstring& name : names ) {
+    files.push_back(g_root / name);
+  }
+
+  const RenameEngine engine(rename);
+  plan.plan(files, engine);
+}
+
+void renameFiles(RenamePlan& plan, const Rename& rename, const Names& names)
+{
+  planFiles(plan, rename, names);
+  plan.execute();
+}
+
+void testRenamePlan()
+{
+  cs::println("*** RenamePlan");
+
+  // (1) Swap ////////////////////////////////////////////////////////////////
+
+  {
+    const Names names{L"ab", L"ba"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Regex, L"^(.)(.)$", L"$2$1"), names);
+
+    check(plan.count(Status::Renamed) == 2, "Swap: Renamed");
+    check(listFiles() == Contents{{L"ab", L"ba"}, {L"ba", L"ab"}}, "Swap: Files");
+  }
+
+  // (2) Cycle ///////////////////////////////////////////////////////////////
+
+  {
+    const Names names{L"abc", L"bca", L"cab"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Regex, L"^(.)(.)(.)$", L"$2$3$1"), names);
+
+    check(plan.count(Status::Renamed) == 3, "Cycle: Renamed");
+    check(listFiles() == Contents{{L"bca", L"abc"}, {L"cab", L"bca"}, {L"abc", L"cab"}}, "Cycle: Files");
+  }
+
+  // (3) Chain ///////////////////////////////////////////////////////////////
+
+  {
+    const Names names{L"1", L"11", L"111"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Append, L"1"), names);
+
+    check(plan.count(Status::Renamed) == 3, "Chain: Renamed");
+    check(listFiles() == Contents{{L"11", L"1"}, {L"111", L"11"}, {L"1111", L"111"}}, "Chain: Files");
+  }
+
+  // (4) Chain Blocked by an Unselected File /////////////////////////////////
+
+  {
+    const Names names{L"1", L"11", L"111", L"1111"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Append, L"1"), {L"1", L"11", L"111"});
+
+    check(plan.count(Status::Exists) == 1 && plan.count(Status::Blocked) == 2, "Blocked chain: Status");
+    check(listFiles() == unchanged(names), "Blocked chain: Files");
+  }
+
+  // (5) Case Only ///////////////////////////////////////////////////////////
+
+  {
+    const Names names{L"name.txt"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Regex, L"^n", L"N"), names);
+
+    check(plan.count(Status::Renamed) == 1, "Case only: Renamed");
+    check(listFiles() == Contents{{L"Name.txt", L"name.txt"}}, "Case only: Files");
+  }
+
+  // (6) Target Exists ///////////////////////////////////////////////////////
+
+  {
+    const Names names{L"x.txt", L"OTHER.txt"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Replace, L"x", L"other"), {L"x.txt"});
+
+    check(plan.count(Status::Exists) == 1, "Exists, ignoring case: Status");
+    check(listFiles() == unchanged(names), "Exists, ignoring case: Files");
+  }
+
+  {
+    const Names names{L"a.txt", L"\u00C4.txt"}; // Capital A with diaeresis
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Replace, L"a", L"\u00E4"), {L"a.txt"});
+
+    check(plan.count(Status::Exists) == 1, "Exists, ignoring non-ASCII case: Status");
+    check(listFiles() == unchanged(names), "Exists, ignoring non-ASCII case: Files");
+  }
+
+  // (7) Shared Target ///////////////////////////////////////////////////////
+
+  {
+    const Names names{L"x.txt", L"y.txt"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Regex, L"^.$", L"same"), names);
+
+    check(plan.count(Status::Collision) == 2, "Collision: Status");
+    check(listFiles() == unchanged(names), "Collision: Files");
+  }
+
+  // (8) Many Chains in one Directory ////////////////////////////////////////
+
+  {
+    Names names;
+    Contents expected;
+    for( int i = 0; i < 200; i++ ) {
+      names.push_back(L"file" + std::to_wstring(i));
+      expected[names.back() + L"_new"] = names.back();
+    }
+    makeFiles(names);
+
+    RenamePlan plan;
+    renameFiles(plan, Rename(Rename::Append, L"_new"), names);
+
+    check(plan.count(Status::Renamed) == names.size(), "Many chains: Renamed");
+    check(listFiles() == expected, "Many chains: Files");
+  }
+
+  // (9) Broken Cycle ////////////////////////////////////////////////////////
+
+  /*
+   * NOTE: An open file can not be renamed, i.e. "bca" stays in place. Hence
+   *       "abc" can neither take its target "bca", nor return from its
+   *       temporary name to "abc", which is "cab"'s by then.
+   */
+
+  {
+    const Names names{L"abc", L"bca", L"cab"};
+    makeFiles(names);
+
+    RenamePlan plan;
+    planFiles(plan, Rename(Rename::Regex, L"^(.)(.)(.)$", L"$2$3$1"), names);
+    {
+      const std::ifstream locked(g_root / L"bca");
+      plan.execute();
+    }
+
+    const RenamePlan::Item& item = plan.items().front();
+    check(item.status == Status::Stranded && listFiles().contains(item.current), "Stranded: Status");
+    check(!item.current.empty() && plan.report().find(item.current) != std::wstring::npos, "Stranded: Report");
+  }
+
+  fs::remove_all(g_root);
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  try {
+    g_root = fs::temp_directory_path() / L"csMenu3_test_rename";
+
+    testRegex();
+    testMultiReplace();
+    testSortKey();
+    testRenamePlan();
+  } catch( const std::exception& e ) {
+    cs::printerrln("ERROR: %", e.what());
+    return EXIT_FAILURE;
+  }
+
+  cs::println("*** % check(s) failed", g_numFailed);
+
+  ThreadPool::instance().release(); // Join idle workers before exit
+
+  return g_numFailed == 0
+         ? EXIT_SUCCESS
+         : EXIT_FAILURE;
+}